@@ -0,0 +1,312 @@
+// *******************************************************
+//
+// adcSampler.c
+//
+// Acquisition of altitude samples from ADC0 (channel 9).
+// Samples are handed to the main loop through a lock-free
+// SPSC ring (spscBufT.h). See adcSampler.h for the modes.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_adc.h"
+#include "driverlib/adc.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "spscBufT.h"
+#include "decimator.h"
+#include "adcSampler.h"
+
+static spscBuf_t *sampleRing;               // Where completed samples are written
+static cicDecimator_t decimator;            // Oversampled to 100 Hz decimation filter
+
+#if ADC_SAMPLER_MODE == ADC_MODE_UDMA
+// The uDMA control table must be aligned to 1024 bytes
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(udmaControlTable, 1024)
+static uint8_t udmaControlTable[1024];
+#else
+static uint8_t udmaControlTable[1024] __attribute__ ((aligned(1024)));
+#endif
+
+static uint16_t pingBuffer[ADC_BLOCK_SIZE]; // Filled by the primary uDMA structure
+static uint16_t pongBuffer[ADC_BLOCK_SIZE]; // Filled by the alternate uDMA structure
+#endif
+
+
+//*****************************************************************************
+//
+// Runs a completed block of samples through the decimator and writes each
+// output to the sample ring. Called from the uDMA completion interrupt for
+// each half buffer.
+//
+//*****************************************************************************
+void processSampleBlock(const uint16_t *block, uint32_t count) {
+    uint32_t output;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (cicDecimate(&decimator, block[i], &output)) {
+            writeSpscBuf(sampleRing, output);
+        }
+    }
+}
+
+
+#if ADC_SAMPLER_MODE == ADC_MODE_UDMA
+//*****************************************************************************
+//
+// The handler for the ADC uDMA transfer complete interrupt.
+// One of the ping-pong halves is full: process it, then re-arm its uDMA
+// structure while the other half is being filled.
+// On the TM4C123 the uDMA signals a completed transfer on the sequence 3
+// interrupt, so it is cleared as a sequence interrupt. Each structure is
+// checked for the stop mode, so an interrupt with no completed transfer
+// does nothing.
+//
+//*****************************************************************************
+void
+ADCDMAIntHandler(void) {
+    ADCIntClear(ADC0_BASE, ADC_SEQUENCE_THREE);
+
+    // A structure that has finished its transfer is back in the stop mode
+    if (uDMAChannelModeGet(UDMA_CHANNEL_ADC3 | UDMA_PRI_SELECT) == UDMA_MODE_STOP) {
+        processSampleBlock(pingBuffer, ADC_BLOCK_SIZE);
+        uDMAChannelTransferSet(UDMA_CHANNEL_ADC3 | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+                               (void *)(ADC0_BASE + ADC_O_SSFIFO3), pingBuffer, ADC_BLOCK_SIZE);
+    }
+
+    if (uDMAChannelModeGet(UDMA_CHANNEL_ADC3 | UDMA_ALT_SELECT) == UDMA_MODE_STOP) {
+        processSampleBlock(pongBuffer, ADC_BLOCK_SIZE);
+        uDMAChannelTransferSet(UDMA_CHANNEL_ADC3 | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+                               (void *)(ADC0_BASE + ADC_O_SSFIFO3), pongBuffer, ADC_BLOCK_SIZE);
+    }
+}
+
+
+//*****************************************************************************
+//
+// Initialisation for the uDMA channel of ADC0 sequence 3 in ping-pong mode.
+//
+//*****************************************************************************
+static void
+initADCDMA(void) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    uDMAEnable();
+    uDMAControlBaseSet(udmaControlTable);
+
+    // Single requests only, normal priority, using both structures
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_ADC3, UDMA_ATTR_ALL);
+
+    // 16-bit transfers from the fixed FIFO address into the buffer
+    uDMAChannelControlSet(UDMA_CHANNEL_ADC3 | UDMA_PRI_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+    uDMAChannelControlSet(UDMA_CHANNEL_ADC3 | UDMA_ALT_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+
+    uDMAChannelTransferSet(UDMA_CHANNEL_ADC3 | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+                           (void *)(ADC0_BASE + ADC_O_SSFIFO3), pingBuffer, ADC_BLOCK_SIZE);
+    uDMAChannelTransferSet(UDMA_CHANNEL_ADC3 | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+                           (void *)(ADC0_BASE + ADC_O_SSFIFO3), pongBuffer, ADC_BLOCK_SIZE);
+
+    uDMAChannelEnable(UDMA_CHANNEL_ADC3);
+}
+
+
+#elif ADC_SAMPLER_MODE == ADC_MODE_TIMER
+//*****************************************************************************
+//
+// The handler for the timer triggered ADC conversion complete interrupt.
+// Feeds the sample to the decimator and writes any output to the ring.
+//
+//*****************************************************************************
+void
+ADCIntHandler(void) {
+    uint32_t ulValue;
+    uint32_t output;
+
+    ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCE_THREE, &ulValue);
+
+    if (cicDecimate(&decimator, ulValue, &output)) {
+        writeSpscBuf(sampleRing, output);
+    }
+
+    ADCIntClear(ADC0_BASE, ADC_SEQUENCE_THREE);
+}
+
+#elif ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+//*****************************************************************************
+//
+// The handler for the sequence 0 complete interrupt.
+// Writes all of the samples from the sequence to the ring in one go.
+//
+//*****************************************************************************
+void
+ADCIntHandler(void) {
+    uint32_t samples[ADC_MULTISTEP_COUNT];
+    int32_t count;
+
+    count = ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCE_ZERO, samples);
+    writeSpscBufBulk(sampleRing, samples, count);
+
+    ADCIntClear(ADC0_BASE, ADC_SEQUENCE_ZERO);
+}
+
+#else
+//*****************************************************************************
+//
+// The handler for the ADC conversion complete interrupt.
+// Writes the sample to the lock-free sample ring.
+//
+//*****************************************************************************
+void
+ADCIntHandler(void) {
+	uint32_t ulValue;
+	
+	// Get the single sample from ADC0.  ADC_BASE is defined in
+	// inc/hw_memmap.h
+	ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCE_THREE, &ulValue);
+
+	// Place it in the sample ring (publishing the new write index)
+	writeSpscBuf(sampleRing, ulValue);
+
+	// Clean up, clearing the interrupt
+	ADCIntClear(ADC0_BASE, ADC_SEQUENCE_THREE);
+}
+#endif
+
+
+#if ADC_SAMPLER_MODE == ADC_MODE_UDMA || ADC_SAMPLER_MODE == ADC_MODE_TIMER
+//*****************************************************************************
+//
+// Initialisation for TIMER0A as the ADC trigger at ADC_OVERSAMPLE_RATE_HZ.
+//
+//*****************************************************************************
+static void
+initADCTriggerTimer(void) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet() / ADC_OVERSAMPLE_RATE_HZ - 1);
+    TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+    TimerEnable(TIMER0_BASE, TIMER_A);
+}
+#endif
+
+
+//*****************************************************************************
+//
+// Initialisation for the ADC (and the timer and uDMA in the other modes).
+// Samples are written to the given ring.
+//
+//*****************************************************************************
+void 
+initADCSampler(spscBuf_t *ring) {
+#if ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+    uint32_t step;
+#endif
+
+    sampleRing = ring;
+    initCicDecimator(&decimator);
+
+    // The ADC0 peripheral must be enabled for configuration and use.
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+
+#if ADC_HW_OVERSAMPLE != 0
+    // Average ADC_HW_OVERSAMPLE conversions in hardware for each sample
+    ADCHardwareOversampleConfigure(ADC0_BASE, ADC_HW_OVERSAMPLE);
+#endif
+
+#if ADC_SAMPLER_MODE == ADC_MODE_UDMA
+    // Sequence 3 does a single sample each time TIMER0A times out.
+    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_TRIGGER_TIMER, ADC_CHANNEL_ZERO);
+
+    // The interrupt flag still has to be set on each step, it is what
+    // raises the uDMA request.
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_CHANNEL_ZERO, ADC_CTL_CH9 | ADC_CTL_IE |
+                             ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+    ADCSequenceDMAEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+
+    initADCDMA();
+
+    // Interrupt when a uDMA transfer (half buffer) completes. The TM4C123
+    // has no separate ADC uDMA interrupt (ADC_INT_DMA_SS3 is TM4C129 only),
+    // the completion is raised on the sequence 3 interrupt.
+    ADCIntRegister(ADC0_BASE, ADC_SEQUENCE_THREE, ADCDMAIntHandler);
+    ADCIntEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+
+    initADCTriggerTimer();
+#elif ADC_SAMPLER_MODE == ADC_MODE_TIMER
+    // Sequence 3 does a single sample each time TIMER0A times out, with an
+    // interrupt per sample.
+    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_TRIGGER_TIMER, ADC_CHANNEL_ZERO);
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_CHANNEL_ZERO, ADC_CTL_CH9 | ADC_CTL_IE |
+                             ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+    ADCIntRegister(ADC0_BASE, ADC_SEQUENCE_THREE, ADCIntHandler);
+    ADCIntEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+
+    initADCTriggerTimer();
+#elif ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+    // Sequence 0 takes ADC_MULTISTEP_COUNT samples of channel 9 each time
+    // the processor triggers it, and interrupts after the last one.
+    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCE_ZERO, ADC_TRIGGER_PROCESSOR, ADC_CHANNEL_ZERO);
+    for (step = 0; step < ADC_MULTISTEP_COUNT - 1; step++) {
+        ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_ZERO, step, ADC_CTL_CH9);
+    }
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_ZERO, step, ADC_CTL_CH9 | ADC_CTL_IE |
+                             ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCE_ZERO);
+    ADCIntRegister(ADC0_BASE, ADC_SEQUENCE_ZERO, ADCIntHandler);
+    ADCIntEnable(ADC0_BASE, ADC_SEQUENCE_ZERO);
+#else
+    // Enable sample sequence 3 with a processor signal trigger.  Sequence 3
+    // will do a single sample when the processor sends a signal to start the
+    // conversion.
+    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_TRIGGER_PROCESSOR, ADC_CHANNEL_ZERO);
+  
+
+    // Configure step 0 on sequence 3.  Sample channel 0 (ADC_CTL_CH0) in
+    // single-ended mode (default) and configure the interrupt flag
+    // (ADC_CTL_IE) to be set when the sample is done.  Tell the ADC logic
+    // that this is the last conversion on sequence 3 (ADC_CTL_END).  Sequence
+    // 3 has only one programmable step.  Sequence 1 and 2 have 4 steps, and
+    // sequence 0 has 8 programmable steps.  Since we are only doing a single
+    // conversion using sequence 3 we will only configure step 0.  For more
+    // on the ADC sequences and steps, refer to the LM3S1968 datasheet.
+    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_CHANNEL_ZERO, ADC_CTL_CH9 | ADC_CTL_IE |
+                             ADC_CTL_END);    
+                             
+    // Since sample sequence 3 is now configured, it must be enabled.
+    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+  
+    // Register the interrupt handler
+    ADCIntRegister(ADC0_BASE, ADC_SEQUENCE_THREE, ADCIntHandler);
+  
+    // Enable interrupts for ADC0 sequence 3 (clears any outstanding interrupts)
+    ADCIntEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
+#endif
+}
+
+
+//*****************************************************************************
+//
+// Starts a single conversion. Called from the SysTick handler. Does nothing
+// in the timer triggered modes.
+//
+//*****************************************************************************
+void triggerADCSample(void) {
+#if ADC_SAMPLER_MODE == ADC_MODE_PROCESSOR
+    // Initiate a conversion
+    ADCProcessorTrigger(ADC0_BASE, ADC_SEQUENCE_THREE);
+#elif ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+    // Initiate a sequence of conversions
+    ADCProcessorTrigger(ADC0_BASE, ADC_SEQUENCE_ZERO);
+#endif
+}
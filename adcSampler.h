@@ -0,0 +1,150 @@
+#ifndef ADCSAMPLER_H_
+#define ADCSAMPLER_H_
+
+// *******************************************************
+//
+// adcSampler.c
+//
+// Acquisition of altitude samples from ADC0 (channel 9).
+// Samples are handed to the main loop through a lock-free
+// SPSC ring (spscBufT.h).
+//
+// Four acquisition modes are available, chosen at build time
+// with ADC_SAMPLER_MODE:
+//  ADC_MODE_PROCESSOR - SysTick calls triggerADCSample() which
+//      starts one conversion, and an interrupt per sample
+//      writes it to the ring (SAMPLE_RATE_HZ samples/s).
+//  ADC_MODE_TIMER - TIMER0A triggers ADC0 at
+//      ADC_OVERSAMPLE_RATE_HZ. An interrupt per sample feeds the
+//      CIC decimator (decimator.h), which writes every
+//      CIC_DECIMATION'th output to the ring.
+//  ADC_MODE_UDMA - TIMER0A triggers ADC0 at
+//      ADC_OVERSAMPLE_RATE_HZ and the uDMA streams the results
+//      into the ping-pong halves of a sample buffer. The CPU is
+//      interrupted once per half buffer and runs the block
+//      through the CIC decimator. The TM4C123 raises the uDMA
+//      completion on the sequence 3 interrupt. That the sequence
+//      interrupt then comes only at completion, and not also for
+//      each conversion (ADC_CTL_IE is set to request the uDMA),
+//      has not been confirmed on the board. If it does come for
+//      each conversion the samples are still right, but the CPU
+//      cost is that of ADC_MODE_TIMER. test/testAdcSampler.c runs
+//      this mode against a simulated uDMA.
+//  ADC_MODE_MULTISTEP - as ADC_MODE_PROCESSOR, but each trigger
+//      runs sequence 0, which takes ADC_MULTISTEP_COUNT samples.
+//      The ISR bulk-writes them all to the ring.
+// The decimated modes write to the ring at
+// ADC_OVERSAMPLE_RATE_HZ / CIC_DECIMATION = 100 Hz, with far less
+// noise and delay than the 40-sample mean, so the main loop only
+// needs a short mean window (ADC_MEAN_WINDOW) after them.
+//
+// Independently of the mode, ADC_HW_OVERSAMPLE (2 to 64) makes the
+// ADC average that many conversions in hardware for every sample
+// it returns, at no CPU cost. 0 turns it off.
+//
+// Comparison of the modes. Noise is the standard deviation of the
+// altitude mean relative to one conversion, assuming white noise.
+// CPU for TIMER and UDMA is measured on the host
+// (test/benchAdcSampler.c), per conversion: the handler and CIC work
+// is the same in both, within +/- 15%, so they differ only in
+// interrupts per conversion, 1 against 1/32. The entry/exit cost of
+// those interrupts is not in the host figure, and neither mode has
+// been measured on the target. The PROCESSOR and MULTISTEP rows are
+// still estimates (about 25 cycles of interrupt entry/exit and 100
+// of driverlib calls and ring writes per interrupt).
+//
+//  Mode              ISRs/s  Window   Delay    Noise   CPU
+//  PROCESSOR           100   40       200 ms   0.158   est. 13k cycles/s
+//  PROCESSOR, HW 64x   100   40       200 ms   0.020   est. 13k cycles/s
+//  MULTISTEP (8)       100   40 (5)    25 ms   0.158   est. 16k cycles/s
+//  MULTISTEP, HW 8x    100   40 (5)    25 ms   0.056   est. 16k cycles/s
+//  TIMER             3 200    4        30 ms   0.083   host 6-10 ns/conv.
+//  UDMA                100    4        30 ms   0.083   host 6-10 ns/conv.
+// (Window is the ring samples averaged by the main loop, with the
+// number of triggers it spans in brackets.)
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "spscBufT.h"
+#include "decimator.h"
+
+#define ADC_MODE_PROCESSOR 0
+#define ADC_MODE_UDMA 1
+#define ADC_MODE_TIMER 2
+#define ADC_MODE_MULTISTEP 3
+
+#ifndef ADC_SAMPLER_MODE
+#define ADC_SAMPLER_MODE ADC_MODE_PROCESSOR
+#endif
+
+#ifndef ADC_HW_OVERSAMPLE
+#define ADC_HW_OVERSAMPLE 0
+#endif
+
+#if ADC_HW_OVERSAMPLE != 0 && ADC_HW_OVERSAMPLE != 2 && ADC_HW_OVERSAMPLE != 4 && \
+    ADC_HW_OVERSAMPLE != 8 && ADC_HW_OVERSAMPLE != 16 && ADC_HW_OVERSAMPLE != 32 && \
+    ADC_HW_OVERSAMPLE != 64
+#error "ADC_HW_OVERSAMPLE must be 0 or a power of two from 2 to 64"
+#endif
+
+#define ADC_SEQUENCE_ZERO 0
+#define ADC_SEQUENCE_THREE 3
+#define ADC_CHANNEL_ZERO 0
+
+// Multi-step mode: sequence 0 has 8 steps
+#define ADC_MULTISTEP_COUNT 8
+
+// Timer and uDMA modes: 3.2 kHz sampling, decimated by 32 to 100 Hz.
+// Each uDMA half buffer holds exactly one decimator output period.
+#define ADC_OVERSAMPLE_RATE_HZ 3200
+#define ADC_BLOCK_SIZE CIC_DECIMATION
+
+// Rate at which samples are written to the ring. The processor triggered
+// modes assume SysTick runs at 100 Hz.
+#if ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+#define ADC_RING_RATE_HZ (100 * ADC_MULTISTEP_COUNT)
+#elif ADC_SAMPLER_MODE == ADC_MODE_PROCESSOR
+#define ADC_RING_RATE_HZ 100
+#else
+#define ADC_RING_RATE_HZ (ADC_OVERSAMPLE_RATE_HZ / CIC_DECIMATION)
+#endif
+
+// Number of ring samples averaged by the main loop
+#if ADC_SAMPLER_MODE == ADC_MODE_PROCESSOR || ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+#define ADC_MEAN_WINDOW 40
+#else
+#define ADC_MEAN_WINDOW 4
+#endif
+
+
+//*****************************************************************************
+//
+// Initialisation for the ADC (and the timer and uDMA in the other modes).
+// Samples are written to the given ring.
+//
+//*****************************************************************************
+void initADCSampler(spscBuf_t *ring);
+
+
+//*****************************************************************************
+//
+// Starts a single conversion. Called from the SysTick handler. Does nothing
+// in the timer triggered modes.
+//
+//*****************************************************************************
+void triggerADCSample(void);
+
+
+//*****************************************************************************
+//
+// Runs a completed block of samples through the decimator and writes each
+// output to the sample ring. Called from the uDMA completion interrupt for
+// each half buffer.
+//
+//*****************************************************************************
+void processSampleBlock(const uint16_t *block, uint32_t count);
+
+#endif /*ADCSAMPLER_H_*/
@@ -19,10 +19,77 @@
 //
 //*****************************************************************************
 int16_t calcPercentAltitude(uint16_t landedADCVal, uint16_t meanADCVal) {
-    // Calculate the number of ADC bits above the zero altitude point
-    int16_t ADCAltitudeBits = landedADCVal - meanADCVal;
+    return Q16_TO_INT(calcAltitudeQ16(landedADCVal, (uint32_t) meanADCVal << 8));
+}
+
+
+//*****************************************************************************
+//
+// Calculates and returns the helicopters altitude as a Q16 percentage, from
+// a Q8 (8 fractional bits) mean ADC value.
+//
+//*****************************************************************************
+q16_t calcAltitudeQ16(uint16_t landedADCVal, uint32_t meanADCValQ8) {
+    // Calculate the number of Q8 ADC bits above the zero altitude point
+    int32_t ADCAltitudeBitsQ8 = ((int32_t) landedADCVal << 8) - (int32_t) meanADCValQ8;
+
+    // Scale to a percentage of maximum altitude with a multiply by the
+    // precomputed reciprocal, rounding to the nearest Q16 step
+    int64_t scaled = (int64_t) ADCAltitudeBitsQ8 * ALTITUDE_SCALE;
+    return (q16_t)((scaled + (1 << (ALTITUDE_SCALE_SHIFT - 1))) >> ALTITUDE_SCALE_SHIFT);
+}
+
+
+//*****************************************************************************
+//
+// Clears the running ADC statistics.
+//
+//*****************************************************************************
+void resetADCStats(adcStats_t *stats) {
+    stats->count = 0;
+    stats->mean = 0;
+    stats->m2 = 0;
+}
+
+
+//*****************************************************************************
+//
+// Adds an ADC sample to the running statistics. Welford's update only needs
+// the running mean and the sum of squared differences, so no samples are
+// stored and there is no catastrophic cancellation from a sum of squares.
+//
+//*****************************************************************************
+void updateADCStats(adcStats_t *stats, uint32_t sample) {
+    q16_t sampleQ16 = INT_TO_Q16((int32_t) sample);
+    q16_t delta;
+
+    stats->count++;
+    delta = sampleQ16 - stats->mean;
+    stats->mean += delta / (int32_t) stats->count;
+    stats->m2 += ((int64_t) delta * (sampleQ16 - stats->mean)) >> Q16_SHIFT;
+}
+
+
+//*****************************************************************************
+//
+// Returns the mean of the samples added since the last reset, in Q16 ADC
+// counts.
+//
+//*****************************************************************************
+q16_t getADCStatsMean(adcStats_t *stats) {
+    return stats->mean;
+}
+
 
-    // Calculate the altitude as a percentage of maximum altitude
-    int16_t percentAltitude = (ADCAltitudeBits * PERCENT_CONVERSION) / MAX_ALTITUDE_BITS;
-    return percentAltitude;
+//*****************************************************************************
+//
+// Returns the sample variance of the samples added since the last reset, in
+// Q16 ADC counts^2. Returns 0 with fewer than two samples.
+//
+//*****************************************************************************
+q16_t getADCStatsVariance(adcStats_t *stats) {
+    if (stats->count < 2) {
+        return 0;
+    }
+    return (q16_t)(stats->m2 / (stats->count - 1));
 }
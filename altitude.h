@@ -12,11 +12,29 @@
 //
 // *******************************************************
 
+#include <stdint.h>
+#include "fixedPoint.h"
+
 // 993 ADC bits corresponds to 0.8V - the difference between 0% and 100% altitude
 #define MAX_ALTITUDE_BITS 993
 
 #define PERCENT_CONVERSION 100
 
+// Altitude per Q8 ADC count, in Q16 percent with 24 extra fractional bits:
+// 100 * 2^(16 - 8 + 24) / MAX_ALTITUDE_BITS. Replaces the divide by
+// MAX_ALTITUDE_BITS with a multiply.
+#define ALTITUDE_SCALE_SHIFT 24
+#define ALTITUDE_SCALE ((int32_t)(((uint64_t)PERCENT_CONVERSION << 32) / MAX_ALTITUDE_BITS))
+
+// Running ADC noise statistics, updated one sample at a time with Welford's
+// method. The mean is in Q16 ADC counts and m2 is the sum of squared
+// differences from the mean in Q16 counts^2.
+typedef struct {
+    uint32_t count;
+    q16_t mean;
+    int64_t m2;
+} adcStats_t;
+
 
 //*****************************************************************************
 //
@@ -25,4 +43,48 @@
 //*****************************************************************************
 int16_t calcPercentAltitude(uint16_t landedADCVal, uint16_t meanADCVal);
 
+
+//*****************************************************************************
+//
+// Returns the helicopters altitude as a Q16 percentage, from a Q8 (8
+// fractional bits) mean ADC value.
+//
+//*****************************************************************************
+q16_t calcAltitudeQ16(uint16_t landedADCVal, uint32_t meanADCValQ8);
+
+
+
+//*****************************************************************************
+//
+// Clears the running ADC statistics.
+//
+//*****************************************************************************
+void resetADCStats(adcStats_t *stats);
+
+
+//*****************************************************************************
+//
+// Adds an ADC sample to the running statistics.
+//
+//*****************************************************************************
+void updateADCStats(adcStats_t *stats, uint32_t sample);
+
+
+//*****************************************************************************
+//
+// Returns the mean of the samples added since the last reset, in Q16 ADC
+// counts.
+//
+//*****************************************************************************
+q16_t getADCStatsMean(adcStats_t *stats);
+
+
+//*****************************************************************************
+//
+// Returns the sample variance of the samples added since the last reset, in
+// Q16 ADC counts^2. Returns 0 with fewer than two samples.
+//
+//*****************************************************************************
+q16_t getADCStatsVariance(adcStats_t *stats);
+
 #endif /*ALTITUDE_H_*/
@@ -0,0 +1,145 @@
+// *******************************************************
+//
+// altitudeKalman.c
+//
+// Fixed-point (Q16) Kalman filter estimating the helicopters
+// altitude and vertical velocity from the ADC samples and the
+// main rotor duty cycle. See altitudeKalman.h for the model.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "altitude.h"
+#include "altitudeKalman.h"
+
+static bool running;                // Set once the landed ADC value is known
+static uint16_t landedADC;          // Zero altitude ADC value
+static uint32_t stepSample;         // Samples since the last predict step
+
+static q16_t height;                // Estimated altitude, Q16 %
+static q16_t velocity;              // Estimated velocity, Q16 %/s
+
+// Error covariance, Q16
+static q16_t p00;                   // Altitude variance
+static q16_t p01;                   // Altitude/velocity covariance (= p10)
+static q16_t p11;                   // Velocity variance
+
+
+//*****************************************************************************
+//
+// Starts the filter at zero altitude and velocity, with landedADCVal as the
+// zero altitude ADC value.
+//
+//*****************************************************************************
+void initAltitudeKalman(uint16_t landedADCVal) {
+    landedADC = landedADCVal;
+    height = 0;
+    velocity = 0;
+    p00 = KALMAN_INITIAL_VARIANCE;
+    p01 = 0;
+    p11 = KALMAN_INITIAL_VARIANCE;
+    stepSample = 0;
+    running = true;
+}
+
+
+//*****************************************************************************
+//
+// Updates the zero altitude ADC value used to convert samples to altitude.
+//
+//*****************************************************************************
+void setKalmanLandedADC(uint16_t landedADCVal) {
+    landedADC = landedADCVal;
+}
+
+
+//*****************************************************************************
+//
+// Runs one predict and correct step for a new ADC sample, using the current
+// main rotor duty cycle as the model input. Only the first sample of each
+// KALMAN_SAMPLES_PER_STEP runs the predict step. Does nothing until
+// initAltitudeKalman() has been called.
+//
+//*****************************************************************************
+void updateAltitudeKalman(uint32_t sample, int mainDuty) {
+    q16_t acceleration;
+    q16_t decay;            // 1 - DRAG * dt, the velocity row of F
+    q16_t fp00, fp01, fp11;
+    q16_t innovation;
+    q16_t inverseS;
+    q16_t k0, k1;
+
+    if (!running) {
+        return;
+    }
+
+    if (stepSample == 0) {
+        // Predict: x = F x + B u
+        acceleration = (mainDuty - KALMAN_HOVER_DUTY) * KALMAN_THRUST_GAIN - q16Mul(KALMAN_DRAG, velocity);
+
+        // The rig rests on the ground below zero altitude, which cancels any
+        // downward thrust (e.g. with the rotors off while landed)
+        if (height <= 0 && acceleration < 0) {
+            acceleration = 0;
+            if (velocity < 0) {
+                velocity = 0;
+            }
+        }
+
+        height += q16Mul(velocity, KALMAN_DT);
+        velocity += q16Mul(acceleration, KALMAN_DT);
+
+        // Predict: P = F P F' + Q, with F = [1 dt; 0 decay]
+        decay = Q16_ONE - q16Mul(KALMAN_DRAG, KALMAN_DT);
+        fp00 = p00 + q16Mul(KALMAN_DT, 2 * p01 + q16Mul(KALMAN_DT, p11));
+        fp01 = q16Mul(decay, p01 + q16Mul(KALMAN_DT, p11));
+        fp11 = q16Mul(decay, q16Mul(decay, p11));
+        p00 = fp00 + KALMAN_HEIGHT_NOISE;
+        p01 = fp01;
+        p11 = fp11 + KALMAN_VELOCITY_NOISE;
+    }
+    stepSample = (stepSample + 1) % KALMAN_SAMPLES_PER_STEP;
+
+    // Correct with the sample as a direct altitude measurement (H = [1 0])
+    innovation = calcAltitudeQ16(landedADC, sample << 8) - height;
+
+    // K = P H' / S, S = p00 + R. 2^32 / S is 1/S in Q16, and needs only a
+    // 32-bit divide. Each correction scales p00 by R / S, so p00 stays at or
+    // above 0 and S at or above R: 1/S is at most 11.1, and would overflow
+    // only for S below 2 (R below 0.00003 %^2).
+    inverseS = (q16_t)(UINT32_MAX / (uint32_t)(p00 + KALMAN_MEASUREMENT_NOISE));
+    k0 = q16Mul(p00, inverseS);
+    k1 = q16Mul(p01, inverseS);
+
+    height += q16Mul(k0, innovation);
+    velocity += q16Mul(k1, innovation);
+
+    // P = (I - K H) P
+    p11 -= q16Mul(k1, p01);
+    p01 -= q16Mul(k0, p01);
+    p00 -= q16Mul(k0, p00);
+}
+
+
+//*****************************************************************************
+//
+// Gets the estimated altitude, Q16 percent.
+//
+//*****************************************************************************
+q16_t getKalmanHeight(void) {
+    return height;
+}
+
+
+//*****************************************************************************
+//
+// Gets the estimated vertical velocity, Q16 percent per second.
+//
+//*****************************************************************************
+q16_t getKalmanVelocity(void) {
+    return velocity;
+}
@@ -0,0 +1,110 @@
+#ifndef ALTITUDEKALMAN_H_
+#define ALTITUDEKALMAN_H_
+
+// *******************************************************
+//
+// altitudeKalman.c
+//
+// Fixed-point (Q16) Kalman filter estimating the helicopters
+// altitude and vertical velocity. Each ADC sample first runs a
+// prediction step from a simple model of the main rotor:
+//   acceleration = THRUST_GAIN * (duty - HOVER_DUTY) - DRAG * velocity
+// and then a correction step with the sample as the altitude
+// measurement. Below zero altitude the rig is on the ground and
+// the model does not accelerate downwards. This replaces the long
+// averaging window and gives the controller a velocity for the
+// derivative term.
+//
+// Altitude is in Q16 percent, velocity in Q16 percent/s. The
+// model constants are rig specific and should be identified from
+// a step response.
+//
+// In ADC_MODE_MULTISTEP the ADC_MULTISTEP_COUNT samples of a
+// burst are taken back to back, so the model is stepped once per
+// burst and each sample of it corrects the same prediction. An
+// overrun that drops part of a burst moves the step to a sample
+// later in a burst, which shifts the prediction by less than one
+// burst period.
+//
+// Cost per sample: about 20 32x32->64 multiplies and one 32-bit
+// divide. test/benchAltitudeKalman.c measures 34-43 ns (72-90
+// host cycles) a sample on the x86 host, for relative cost only;
+// the Cortex-M4 cycles are not measured.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "adcSampler.h"
+
+// Samples taken at the same time, which share one model step
+#if ADC_SAMPLER_MODE == ADC_MODE_MULTISTEP
+#define KALMAN_SAMPLES_PER_STEP ADC_MULTISTEP_COUNT
+#else
+#define KALMAN_SAMPLES_PER_STEP 1
+#endif
+
+// Time step of the model, Q16 seconds
+#define KALMAN_DT (Q16_ONE * KALMAN_SAMPLES_PER_STEP / ADC_RING_RATE_HZ)
+
+// Main rotor model
+#define KALMAN_HOVER_DUTY 40                // Duty (%) that holds altitude
+#define KALMAN_THRUST_GAIN Q16(20.0)        // %/s^2 per % duty above hover
+#define KALMAN_DRAG Q16(2.0)                // 1/s
+
+// Noise (Q16 variances). Measurement noise is about 3 ADC counts (0.3%).
+#define KALMAN_MEASUREMENT_NOISE Q16(0.09)  // %^2
+#define KALMAN_HEIGHT_NOISE Q16(0.001)      // %^2 per step
+#define KALMAN_VELOCITY_NOISE Q16(0.5)      // (%/s)^2 per step
+
+// Initial uncertainty
+#define KALMAN_INITIAL_VARIANCE Q16(1.0)
+
+
+//*****************************************************************************
+//
+// Starts the filter at zero altitude and velocity, with landedADCVal as the
+// zero altitude ADC value.
+//
+//*****************************************************************************
+void initAltitudeKalman(uint16_t landedADCVal);
+
+
+//*****************************************************************************
+//
+// Updates the zero altitude ADC value used to convert samples to altitude.
+//
+//*****************************************************************************
+void setKalmanLandedADC(uint16_t landedADCVal);
+
+
+//*****************************************************************************
+//
+// Runs one predict and correct step for a new ADC sample, using the current
+// main rotor duty cycle as the model input. Only the first sample of each
+// KALMAN_SAMPLES_PER_STEP runs the predict step. Does nothing until
+// initAltitudeKalman() has been called.
+//
+//*****************************************************************************
+void updateAltitudeKalman(uint32_t sample, int mainDuty);
+
+
+//*****************************************************************************
+//
+// Gets the estimated altitude, Q16 percent.
+//
+//*****************************************************************************
+q16_t getKalmanHeight(void);
+
+
+//*****************************************************************************
+//
+// Gets the estimated vertical velocity, Q16 percent per second.
+//
+//*****************************************************************************
+q16_t getKalmanVelocity(void);
+
+#endif /*ALTITUDEKALMAN_H_*/
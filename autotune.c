@@ -0,0 +1,177 @@
+// *******************************************************
+//
+// autotune.c
+//
+// Relay feedback experiment for tuning a PID controller, with
+// Ziegler-Nichols gains from the measured ultimate gain and
+// period.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "pid.h"
+#include "autotune.h"
+
+#define FOUR_OVER_PI Q16(1.2732395)
+
+
+//*****************************************************************************
+//
+// Starts a relay experiment. The relay starts high.
+//
+//*****************************************************************************
+void startRelay(relayTune_t *relay, q16_t bias, q16_t amplitude, q16_t hysteresis,
+                uint32_t rateHz, uint32_t timeoutTicks) {
+    relay->bias = bias;
+    relay->amplitude = amplitude;
+    relay->hysteresis = hysteresis;
+    relay->rateHz = rateHz;
+    relay->timeoutTicks = timeoutTicks;
+    relay->ticks = 0;
+    relay->cycleStart = 0;
+    relay->periodTicks = 0;
+    relay->peakToPeak = 0;
+    relay->errorMax = 0;
+    relay->errorMin = 0;
+    relay->cycles = 0;
+    relay->measured = 0;
+    relay->high = true;
+    relay->state = RELAY_RUNNING;
+    relay->ku = 0;
+    relay->tu = 0;
+}
+
+
+//*****************************************************************************
+//
+// Finds Ku and Tu from the measured cycles.
+//
+//*****************************************************************************
+static void calcUltimate(relayTune_t *relay) {
+    int64_t amplitude = relay->peakToPeak / (2 * relay->measured);  // Q16
+    int64_t hysteresis = relay->hysteresis;
+    uint32_t root;
+
+    if (amplitude <= hysteresis) {
+        relay->state = RELAY_FAILED;
+        return;
+    }
+
+    // sqrt(a^2 - hysteresis^2), Q32 under the root so Q16 out
+    root = sqrt64((uint64_t)(amplitude * amplitude - hysteresis * hysteresis));
+    relay->ku = q16Mul(FOUR_OVER_PI, q16Div(relay->amplitude, (q16_t) root));
+    relay->tu = (q16_t)(((int64_t) relay->periodTicks << Q16_SHIFT) / ((int64_t) relay->measured * relay->rateHz));
+    relay->state = RELAY_DONE;
+}
+
+
+//*****************************************************************************
+//
+// Runs one tick of a relay experiment. Each upward switch ends a cycle, after
+// which its period and peak to peak error are added up once the oscillation
+// has had RELAY_SETTLE_CYCLES to settle.
+//
+//*****************************************************************************
+q16_t updateRelay(relayTune_t *relay, q16_t error) {
+    if (relay->state != RELAY_RUNNING) {
+        return relay->bias;
+    }
+
+    relay->ticks++;
+    if (error > relay->errorMax) {
+        relay->errorMax = error;
+    }
+    if (error < relay->errorMin) {
+        relay->errorMin = error;
+    }
+
+    if (relay->high && error < -relay->hysteresis) {
+        relay->high = false;
+    } else if (!relay->high && error > relay->hysteresis) {
+        relay->high = true;
+
+        if (relay->cycles >= RELAY_SETTLE_CYCLES) {
+            relay->periodTicks += relay->ticks - relay->cycleStart;
+            relay->peakToPeak += (int64_t) relay->errorMax - relay->errorMin;
+            relay->measured++;
+        }
+        relay->cycles++;
+        relay->cycleStart = relay->ticks;
+        relay->errorMax = error;
+        relay->errorMin = error;
+
+        if (relay->measured >= RELAY_MEASURE_CYCLES) {
+            calcUltimate(relay);
+            return relay->bias;
+        }
+    }
+
+    if (relay->ticks >= relay->timeoutTicks) {
+        relay->state = RELAY_FAILED;
+        return relay->bias;
+    }
+
+    if (relay->high) {
+        return q16Add(relay->bias, relay->amplitude);
+    } else {
+        return q16Add(relay->bias, -relay->amplitude);
+    }
+}
+
+
+//*****************************************************************************
+//
+// Gets the state of a relay experiment.
+//
+//*****************************************************************************
+uint8_t getRelayState(relayTune_t *relay) {
+    return relay->state;
+}
+
+
+//*****************************************************************************
+//
+// Gets the ultimate gain of a finished experiment.
+//
+//*****************************************************************************
+q16_t getRelayKu(relayTune_t *relay) {
+    return relay->ku;
+}
+
+
+//*****************************************************************************
+//
+// Gets the ultimate period of a finished experiment, in seconds.
+//
+//*****************************************************************************
+q16_t getRelayTu(relayTune_t *relay) {
+    return relay->tu;
+}
+
+
+//*****************************************************************************
+//
+// Gets the Ziegler-Nichols PID gains from a finished experiment.
+//
+//*****************************************************************************
+void calcRelayPID(relayTune_t *relay, pidGains_t *gains) {
+    gains->kp = q16Mul(Q16(0.6), relay->ku);
+    gains->ki = q16Div(q16Mul(Q16(1.2), relay->ku), relay->tu);
+    gains->kd = q16Mul(q16Mul(Q16(0.075), relay->ku), relay->tu);
+}
+
+
+//*****************************************************************************
+//
+// Gets the Ziegler-Nichols PI gains from a finished experiment.
+//
+//*****************************************************************************
+void calcRelayPI(relayTune_t *relay, pidGains_t *gains) {
+    gains->kp = q16Mul(Q16(0.45), relay->ku);
+    gains->ki = q16Div(q16Mul(Q16(0.54), relay->ku), relay->tu);
+    gains->kd = 0;
+}
@@ -0,0 +1,115 @@
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+// *******************************************************
+//
+// autotune.c
+//
+// Relay feedback experiment for tuning a PID controller
+// (Astrom and Hagglund). The controller is replaced by a relay
+// with hysteresis, which switches the output between
+// bias + amplitude and bias - amplitude each time the error
+// crosses +/-hysteresis. Most plants then settle into a limit
+// cycle at their ultimate period Tu.
+//
+// The period is measured between the upward switches of the
+// relay, and the oscillation amplitude a from the extremes of
+// the error in each period. After RELAY_SETTLE_CYCLES cycles
+// are discarded, RELAY_MEASURE_CYCLES cycles are averaged, and
+// the ultimate gain is
+//      Ku = 4 * amplitude / (pi * sqrt(a^2 - hysteresis^2))
+// Gains are then found from Ku and Tu by the Ziegler-Nichols
+// rules.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "pid.h"
+
+#define RELAY_SETTLE_CYCLES 2       // Cycles discarded while the oscillation settles
+#define RELAY_MEASURE_CYCLES 4      // Cycles averaged for Ku and Tu
+
+// States of a relay experiment
+enum relayStates {RELAY_RUNNING = 0, RELAY_DONE, RELAY_FAILED};
+
+typedef struct {
+    q16_t bias;                 // Output at the centre of the relay
+    q16_t amplitude;            // Relay step either side of the bias
+    q16_t hysteresis;           // Error the relay must pass to switch
+    uint32_t rateHz;            // Rate updateRelay() is called at
+    uint32_t timeoutTicks;      // Ticks before the experiment fails
+    uint32_t ticks;             // Ticks since the start
+    uint32_t cycleStart;        // Tick of the last upward switch
+    uint32_t periodTicks;       // Sum of the measured periods, ticks
+    int64_t peakToPeak;         // Sum of the measured peak to peak errors, Q16
+    q16_t errorMax;             // Error extremes in the current cycle
+    q16_t errorMin;
+    uint16_t cycles;            // Upward switches so far
+    uint16_t measured;          // Cycles measured
+    bool high;                  // Relay output is high
+    uint8_t state;              // A relayStates value
+    q16_t ku;                   // Ultimate gain, output units per error unit
+    q16_t tu;                   // Ultimate period, seconds
+} relayTune_t;
+
+
+//*****************************************************************************
+//
+// Starts a relay experiment, all Q16 but the update rate (Hz) and the timeout
+// (ticks).
+//
+//*****************************************************************************
+void startRelay(relayTune_t *relay, q16_t bias, q16_t amplitude, q16_t hysteresis,
+                uint32_t rateHz, uint32_t timeoutTicks);
+
+
+//*****************************************************************************
+//
+// Runs one tick of a relay experiment from the error (reference -
+// measurement), and returns the relay output. The state becomes RELAY_DONE
+// once Ku and Tu are known, or RELAY_FAILED if the oscillation is too small
+// to measure or the timeout passes.
+//
+//*****************************************************************************
+q16_t updateRelay(relayTune_t *relay, q16_t error);
+
+
+//*****************************************************************************
+//
+// Gets the state of a relay experiment, a relayStates value.
+//
+//*****************************************************************************
+uint8_t getRelayState(relayTune_t *relay);
+
+
+//*****************************************************************************
+//
+// Gets the ultimate gain and period of a finished experiment, Q16.
+//
+//*****************************************************************************
+q16_t getRelayKu(relayTune_t *relay);
+q16_t getRelayTu(relayTune_t *relay);
+
+
+//*****************************************************************************
+//
+// Gets the Ziegler-Nichols PID gains from a finished experiment:
+// Kp = 0.6 Ku, Ki = 1.2 Ku / Tu, Kd = 0.075 Ku Tu.
+//
+//*****************************************************************************
+void calcRelayPID(relayTune_t *relay, pidGains_t *gains);
+
+
+//*****************************************************************************
+//
+// Gets the Ziegler-Nichols PI gains from a finished experiment:
+// Kp = 0.45 Ku, Ki = 0.54 Ku / Tu, Kd = 0.
+//
+//*****************************************************************************
+void calcRelayPI(relayTune_t *relay, pidGains_t *gains);
+
+#endif /*AUTOTUNE_H_*/
@@ -2,8 +2,9 @@
 // 
 // circBufT.c
 //
-// Support for a circular buffer of uint32_t values on the 
-//  Tiva processor.
+// Support for a circular buffer of unsigned integer values on the 
+//  Tiva processor. The entry type is set at build time with
+//  CIRCBUF_ENTRY_TYPE (see circBufT.h).
 // P.J. Bones UCECE
 // Last modified:  8.3.2017
 // 
@@ -14,59 +15,99 @@
 #include "circBufT.h"
 
 // *******************************************************
-// initCircBuf: Initialise the circBuf instance. Reset both indices to
+// saturateEntry: limit an entry to CIRCBUF_ENTRY_MAX, so a value too
+// large for circBufEntry_t is not wrapped by the conversion.
+static circBufEntry_t
+saturateEntry(uint32_t entry)
+{
+	if (entry > CIRCBUF_ENTRY_MAX)
+	   return CIRCBUF_ENTRY_MAX;
+	return (circBufEntry_t) entry;
+}
+
+// *******************************************************
+// initCircBuf: Initialise the circBuf instance. Reset the index to
 // the start of the buffer.  Dynamically allocate and clear the the 
 // memory and return a pointer for the data.  Return NULL if 
 // allocation fails.
-uint32_t*
+circBufEntry_t*
 initCircBuf(circBuf_t *buffer, uint32_t size)
 {
 	buffer->windex = 0;
-	buffer->rindex = 0;
+	buffer->sum = 0;
 	buffer->size = size;
 	buffer->data = 
-        (uint32_t*) calloc(size, sizeof(uint32_t));
+        (circBufEntry_t*) calloc(size, sizeof(circBufEntry_t));
 	return buffer->data;
 }
    // Note use of calloc() to clear contents.
 
 // *******************************************************
 // writeCircBuf: insert entry at the current windex location,
-// advance windex, modulo (buffer size).
+// advance windex, modulo (buffer size). The running sum is updated
+// by removing the overwritten entry and adding the new one. The entry
+// is saturated to CIRCBUF_ENTRY_MAX.
 void
 writeCircBuf(circBuf_t *buffer, uint32_t entry)
 {
-	buffer->data[buffer->windex] = entry;
+	circBufEntry_t stored = saturateEntry(entry);
+
+	buffer->sum = buffer->sum - buffer->data[buffer->windex] + stored;
+	buffer->data[buffer->windex] = stored;
 	buffer->windex++;
 	if (buffer->windex >= buffer->size)
 	   buffer->windex = 0;
 }
 
 // *******************************************************
-// readCircBuf: return entry at the current rindex location,
-// advance rindex, modulo (buffer size). The function deos not check
-// if reading has advanced ahead of writing.
-uint32_t
-readCircBuf(circBuf_t *buffer)
+// writeCircBufBulk: insert count entries, oldest first, as if by
+// count calls to writeCircBuf().
+void
+writeCircBufBulk(circBuf_t *buffer, const uint32_t *entries, uint32_t count)
 {
-	uint32_t entry;
-	
-	entry = buffer->data[buffer->rindex];
-	buffer->rindex++;
-	if (buffer->rindex >= buffer->size)
-	   buffer->rindex = 0;
-    return entry;
+	uint32_t sum = buffer->sum;
+	uint32_t windex = buffer->windex;
+	circBufEntry_t stored;
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		stored = saturateEntry(entries[i]);
+		sum = sum - buffer->data[windex] + stored;
+		buffer->data[windex] = stored;
+		windex++;
+		if (windex >= buffer->size)
+		   windex = 0;
+	}
+
+	buffer->windex = windex;
+	buffer->sum = sum;
+}
+
+// *******************************************************
+// fillCircBuf: set every entry to value, as if by size calls to
+// writeCircBuf(), so value is saturated too. Used to seed the buffer with a known value.
+void
+fillCircBuf(circBuf_t *buffer, uint32_t value)
+{
+	circBufEntry_t stored = saturateEntry(value);
+	uint32_t i;
+
+	for (i = 0; i < buffer->size; i++)
+	   buffer->data[i] = stored;
+	buffer->sum = stored * buffer->size;
 }
 
 // *******************************************************
 // freeCircBuf: Releases the memory allocated to the buffer data,
 // sets pointer to NULL and ohter fields to 0. The buffer can
-// re-initialised by another call to initCircBuf().
+// re-initialised by another call to initCircBuf(). Only for buffers
+// allocated by initCircBuf().
 void
 freeCircBuf(circBuf_t * buffer)
 {
 	buffer->windex = 0;
-	buffer->rindex = 0;
+	buffer->sum = 0;
 	buffer->size = 0;
 	free(buffer->data);
 	buffer->data = NULL;
@@ -74,22 +115,25 @@ freeCircBuf(circBuf_t * buffer)
 
 //*****************************************************************************
 //
-// Returns the mean value of the buffers contents.
+// Returns the rounded mean of the buffers contents from the running sum.
+// Runs in constant time. Interrupts do not need to be disabled as long as the
+// buffer is written and read from the same context; in main.c both happen in
+// updateAltitude().
 //
 //*****************************************************************************
 int32_t
-calcMeanOfContents(circBuf_t *buffer, uint16_t bufferSize)
+getCircBufMean(circBuf_t *buffer)
 {
-    int32_t mean;
-    uint16_t i;
-    int32_t sum;
-
-    sum = 0;
-    for (i = 0; i < bufferSize; i++)
-    {
-        sum = sum + readCircBuf (buffer);
-    }
+    return (2 * buffer->sum + buffer->size) / 2 / buffer->size;
+}
 
-    mean = (2 * sum + bufferSize) / 2 / bufferSize;
-    return mean;
+//*****************************************************************************
+//
+// As getCircBufMean(), but returns the mean with 8 fractional bits (Q8).
+//
+//*****************************************************************************
+uint32_t
+getCircBufMeanQ8(circBuf_t *buffer)
+{
+    return ((buffer->sum << 8) + buffer->size / 2) / buffer->size;
 }
@@ -5,57 +5,101 @@
 // 
 // circBufT.h
 //
-// Support for a circular buffer of uint32_t values on the 
-//  Tiva processor.
+// Support for a circular buffer of unsigned integer values on the 
+//  Tiva processor. The entry type is set at build time with
+//  CIRCBUF_ENTRY_TYPE. Buffers can be allocated on the heap
+//  with initCircBuf() or statically with CIRCBUF_STATIC().
 // P.J. Bones UCECE
 // Last modified:  7.3.2017
 // 
 // *******************************************************
 #include <stdint.h>
 
+// *******************************************************
+// Entry type. 12-bit ADC samples fit in uint16_t, which halves the
+// RAM used by a buffer compared with uint32_t. Define CIRCBUF_ENTRY_TYPE
+// (an unsigned type) for the whole build to change it. Every buffer in
+// the build shares it. Entries above CIRCBUF_ENTRY_MAX are saturated to
+// it when written.
+#ifndef CIRCBUF_ENTRY_TYPE
+#define CIRCBUF_ENTRY_TYPE uint16_t
+#endif
+
+typedef CIRCBUF_ENTRY_TYPE circBufEntry_t;
+
+#define CIRCBUF_ENTRY_MAX ((circBufEntry_t) ~(circBufEntry_t) 0)
+
 // *******************************************************
 // Buffer structure
 typedef struct {
 	uint32_t size;		// Number of entries in buffer
 	uint32_t windex;	// index for writing, mod(size)
-	uint32_t rindex;	// index for reading, mod(size)
-	uint32_t *data;		// pointer to the data
+	uint32_t sum;		// running sum of all entries, kept by writeCircBuf()
+	circBufEntry_t *data;	// pointer to the data
 } circBuf_t;
 
 // *******************************************************
-// initCircBuf: Initialise the circBuf instance. Reset both indices to
+// CIRCBUF_STATIC: Define a buffer called name with bufSize entries of
+// statically allocated storage. The buffer is ready to use without a
+// call to initCircBuf() and must not be passed to freeCircBuf().
+// Usage: CIRCBUF_STATIC(g_inBuffer, BUF_SIZE);
+#define CIRCBUF_STATIC(name, bufSize) \
+    static circBufEntry_t name##Storage[(bufSize)]; \
+    static circBuf_t name = {(bufSize), 0, 0, name##Storage}
+
+// *******************************************************
+// initCircBuf: Initialise the circBuf instance. Reset the index to
 // the start of the buffer.  Dynamically allocate and clear the the 
 // memory and return a pointer for the data.  Return NULL if 
 // allocation fails.
-uint32_t *
+circBufEntry_t *
 initCircBuf(circBuf_t *buffer, uint32_t size);
 
 // *******************************************************
 // writeCircBuf: insert entry at the current windex location,
-// advance windex, modulo (buffer size).
+// advance windex, modulo (buffer size). The running sum is updated
+// by removing the overwritten entry and adding the new one. The entry
+// is saturated to CIRCBUF_ENTRY_MAX.
 void
 writeCircBuf(circBuf_t *buffer, uint32_t entry);
 
 // *******************************************************
-// readCircBuf: return entry at the current rindex location,
-// advance rindex, modulo (buffer size). The function deos not check
-// if reading has advanced ahead of writing.
-uint32_t
-readCircBuf(circBuf_t *buffer);
+// writeCircBufBulk: insert count entries, oldest first, as if by
+// count calls to writeCircBuf().
+void
+writeCircBufBulk(circBuf_t *buffer, const uint32_t *entries, uint32_t count);
+
+// *******************************************************
+// fillCircBuf: set every entry to value, as if by size calls to
+// writeCircBuf(), so value is saturated too. Used to seed the buffer with a known value.
+void
+fillCircBuf(circBuf_t *buffer, uint32_t value);
 
 // *******************************************************
 // freeCircBuf: Releases the memory allocated to the buffer data,
 // sets pointer to NULL and other fields to 0. The buffer can
-// re initialised by another call to initCircBuf().
+// re initialised by another call to initCircBuf(). Only for buffers
+// allocated by initCircBuf().
 void
 freeCircBuf(circBuf_t *buffer);
 
 //*****************************************************************************
 //
-// Returns the mean value of the buffers contents.
+// Returns the rounded mean of the buffers contents from the running sum.
+// Runs in constant time. Interrupts do not need to be disabled as long as the
+// buffer is written and read from the same context; in main.c both happen in
+// updateAltitude().
 //
 //*****************************************************************************
 int32_t
-calcMeanOfContents(circBuf_t *buffer, uint16_t bufferSize);
+getCircBufMean(circBuf_t *buffer);
+
+//*****************************************************************************
+//
+// As getCircBufMean(), but returns the mean with 8 fractional bits (Q8).
+//
+//*****************************************************************************
+uint32_t
+getCircBufMeanQ8(circBuf_t *buffer);
 
 #endif /*CIRCBUFT_H_*/
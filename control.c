@@ -3,7 +3,8 @@
 // control.c
 //
 // Implements PID controllers for the helicopter.
-// The controllers take altitude as a percentage, and yaw in slot counts.
+// The controllers take altitude as a Q16 percentage, and yaw as a binary
+// angle (yaw.h), so the yaw error always takes the shorter way round.
 // This module uses getter functions so other modules can access control values,
 // and setter functions so other modules can alter control values.
 //
@@ -19,38 +20,217 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "feedforward.h"
+#include "gainSchedule.h"
+#include "autotune.h"
+#include "trajectory.h"
 #include "control.h"
 #include "pwm.h"
 #include "yaw.h"
 #include "uartHeli.h"
+#include "timestamp.h"
+#include "priorities.h"
 
 static int referencePercentHeight;              // Altitude reference
-static int currentPercentHeight;                // Current altitude
-static int heightError;                         // Altitude error
+static q16_t currentHeight;                     // Current altitude, Q16 percent
+static q16_t heightError;                       // Altitude error, Q16 percent
+static q16_t heightVelocity;                    // Vertical velocity, Q16 percent/s
+static bool heightVelocityValid;                // Set if an estimator supplies the velocity
 
-static int referenceYaw;                        // Reference yaw
-static int currentYaw;                          // Current yaw
-static int yawError;                            // Yaw error
+static bam_t referenceYaw;                      // Reference yaw
+static bam_t currentYaw;                        // Current yaw
+static q16_t yawError;                          // Yaw error, Q16 slots
+static q16_t yawRate;                           // Yaw rate, Q16 slots/s
+static bool yawRateValid;                       // Set if a yaw rate estimate is supplied
 
 static uint8_t currentMode;                     // Current helicopter mode
 
-static int closestRef;                          // For determining the fastest way to the reference
+static bam_t closestRef;                        // For determining the fastest way to the reference
 
-static double heightErrorDerivative;
-static double heightErrorPrevious;
-static double heightErrorIntegrated;
+static pidController_t mainPID;                // Altitude controller, percent in, duty out
+static pidController_t tailPID;                 // Yaw controller, slots in, duty (or slots/s) out
+static q16_t previousHeight;                    // For the altitude rate without an estimator
+static bam_t previousYaw;                       // For the yaw rate without an estimator
 
-static double yawErrorDerivative;
-static double yawErrorPrevious;
-static double yawErrorIntegrated;
+static trajectory_t heightProfile;              // Altitude reference profile, Q16 percent
+static trajectory_t yawProfile;                 // Yaw reference profile, Q16 slots
+static bam_t yawProfileReference;               // Reference yaw the profile is moving to
+static q16_t tailProfileFeedforward;            // Tail duty to follow the yaw profile, Q16 percent
+static bool tailIntegralHeld;                   // Set while the yaw profile moves when flying
 
 static int outputMain;                          // Output main rotor PWM duty cycle
 static int outputTail;                          // Output tail rotor PWM duty cycle
 
-static volatile int lastRefCrossing;            // Slot count of last crossing of the independent yaw reference
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+static pidController_t tailRatePID;             // Inner yaw rate controller, slots/s in, duty out
+static volatile q16_t yawRateReference;         // Outer loop output, Q16 slots/s
+static volatile bool yawRateLoopEnabled;        // Set while the inner loop drives the tail
+static volatile uint32_t yawRateLoopCycles;     // Longest inner loop run, cycles
+static pidController_t *const tailDutyPID = &tailRatePID; // The controller that sets the tail duty
+#else
+static pidController_t *const tailDutyPID = &tailPID;
+#endif
+static int steadyTicks;                         // Control ticks of steady hover
+
+// Auto-tuning stages
+enum autotuneStages {TUNE_SETTLE = 0, TUNE_ALTITUDE, TUNE_YAW};
+static uint8_t tuneStage;                       // Axis being tuned
+static uint32_t tuneTicks;                      // Ticks spent settling
+static uint32_t settledTicks;                   // Ticks the altitude has been settled
+static relayTune_t relay;                       // Relay experiment on that axis
+
+// Auto-tuning results waiting to be sent by serviceControl()
+#define TUNE_REPORTS 2                          // Must be a power of two
+typedef struct {
+    char *loop;
+    q16_t ku;
+    q16_t tu;
+    pidGains_t gains;
+    bool failed;
+} tuneReport_t;
+static tuneReport_t tuneReports[TUNE_REPORTS];
+static volatile uint8_t tuneReportHead;         // Written by the controller
+static volatile uint8_t tuneReportTail;         // Written by serviceControl()
+static volatile bool feedforwardSavePending;    // Set after a landing
+
+static volatile bam_t lastRefCrossing;          // Yaw angle of last crossing of the independent yaw reference
 static int yawFind = REFERENCE_FIND_INCREMENT;  // For finding the independent reference
 
 
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+//*****************************************************************************
+//
+// The interrupt handler for the inner yaw rate loop, on TIMER3A.
+// Updates the yaw rate estimate, then runs the rate PI controller while the
+// outer loop has enabled it. The run time is measured from entry to exit.
+//
+//*****************************************************************************
+void yawRateLoopIntHandler(void) {
+    uint32_t start = getTimestamp();
+    uint32_t cycles;
+
+    TimerIntClear(TIMER3_BASE, TIMER_TIMA_TIMEOUT);
+
+    updateYawRate();
+
+    if (yawRateLoopEnabled) {
+        // No derivative term on the inner loop
+        outputTail = q16ToNearestInt(updatePID(&tailRatePID, q16Add(yawRateReference, -getYawRate()), 0));
+        setTailPWM(PWM_TAIL_START_RATE_HZ, outputTail);
+    }
+
+    cycles = getTimestamp() - start;
+    if (cycles > yawRateLoopCycles) {
+        yawRateLoopCycles = cycles;
+    }
+}
+#endif
+
+
+//*****************************************************************************
+//
+// Initialises the altitude and yaw PID controllers, loads the tail
+// feedforward table, and in the YAW_CONTROL_CASCADE mode starts the inner
+// yaw rate loop on TIMER3.
+//
+//*****************************************************************************
+void initControl(void) {
+    initFeedforward();
+    initTrajectory(&heightProfile, HEIGHT_PROFILE_VELOCITY, HEIGHT_PROFILE_ACCELERATION,
+                   HEIGHT_PROFILE_JERK_TICKS, CONTROL_RATE_HZ, 0, ZERO_HEIGHT);
+    initTrajectory(&yawProfile, YAW_PROFILE_VELOCITY, YAW_PROFILE_ACCELERATION,
+                   YAW_PROFILE_JERK_TICKS, CONTROL_RATE_HZ, INT_TO_Q16(TOTAL_SLOTS), ZERO_YAW);
+    initPID(&mainPID, KpMain, KiMain, KdMain, DELTA_T, HEIGHT_DERIVATIVE_TAU,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+    // The outer loop is proportional only, the inner integrator takes up
+    // the tail torque offset
+    initPID(&tailPID, KpYaw, 0, 0, DELTA_T, 0,
+            -INT_TO_Q16(YAW_RATE_REF_MAX), INT_TO_Q16(YAW_RATE_REF_MAX));
+    initPID(&tailRatePID, KpTailRate, KiTailRate, 0, YAW_RATE_DELTA_T, 0,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER3);
+    TimerConfigure(TIMER3_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER3_BASE, TIMER_A, SysCtlClockGet() / YAW_RATE_LOOP_HZ - 1);
+    TimerIntRegister(TIMER3_BASE, TIMER_A, yawRateLoopIntHandler);
+    TimerIntEnable(TIMER3_BASE, TIMER_TIMA_TIMEOUT);
+    TimerEnable(TIMER3_BASE, TIMER_A);
+#else
+    initPID(&tailPID, KpTail, KiTail, KdTail, DELTA_T, YAW_DERIVATIVE_TAU,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+#endif
+}
+
+
+//*****************************************************************************
+//
+// Queues an auto-tuning result for serviceControl() to send. A null gains
+// pointer reports that the experiment failed. The result is dropped if the
+// queue is full.
+//
+//*****************************************************************************
+static void queueTuneResult(char *loop, q16_t ku, q16_t tu, const pidGains_t *gains) {
+    tuneReport_t *report;
+
+    if ((uint8_t)(tuneReportHead - tuneReportTail) >= TUNE_REPORTS) {
+        return;
+    }
+
+    report = &tuneReports[tuneReportHead & (TUNE_REPORTS - 1)];
+    report->loop = loop;
+    report->ku = ku;
+    report->tu = tu;
+    report->failed = (gains == NULL);
+    if (gains) {
+        report->gains = *gains;
+    }
+    tuneReportHead++;
+}
+
+
+//*****************************************************************************
+//
+// Does the slow work queued by the controller, from the main loop.
+//
+//*****************************************************************************
+void serviceControl(void) {
+    tuneReport_t *report;
+
+    if (feedforwardSavePending) {
+        feedforwardSavePending = false;
+        saveFeedforward();
+    }
+
+    while (tuneReportTail != tuneReportHead) {
+        report = &tuneReports[tuneReportTail & (TUNE_REPORTS - 1)];
+        UARTSendTuneResult(report->loop, report->ku, report->tu,
+                           report->failed ? NULL : &report->gains);
+        tuneReportTail++;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Gets the longest run of the inner yaw rate loop interrupt, in system clock
+// cycles.
+//
+//*****************************************************************************
+uint32_t getYawRateLoopCycles(void) {
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+    return yawRateLoopCycles;
+#else
+    return 0;
+#endif
+}
+
+
 //*****************************************************************************
 //
 // Finds the independent yaw reference point.
@@ -63,19 +243,24 @@ void findIndependentYawReference(void) {
     setReferenceHeight(TAKE_OFF_HEIGHT);
 
     // Begin rotating to find the reference
-    setReferenceYaw(yawFind);
+    setReferenceYaw(slotsToBam(yawFind));
 
     // Rotate more if the error is small enough
     // Helps with stability
-    if (yawError < REFERENCE_FIND_TOLERANCE) {
+    if (yawError < INT_TO_Q16(REFERENCE_FIND_TOLERANCE)) {
         yawFind += REFERENCE_FIND_INCREMENT;
     }
 
-    // If the reference has been crossed, set the slot count to zero and begin
-    // flying while facing the reference
+    // If the reference has been crossed, set the slot count to zero at the
+    // crossing and begin flying while facing the reference
     if (lastRefCrossing != ZERO_YAW) {
-        resetYawSlots();
+        alignYawToReference();
         setReferenceYaw(ZERO_YAW);
+
+        // The yaw has just been moved to the reference, so the profile
+        // starts there rather than moving to it
+        resetTrajectory(&yawProfile, ZERO_YAW);
+        yawProfileReference = ZERO_YAW;
         lastRefCrossing = ZERO_YAW;
         setMode(FLYING);
     }
@@ -84,36 +269,63 @@ void findIndependentYawReference(void) {
 
 //*****************************************************************************
 //
-// Sets the last reference crossing value to the current yaw slot count when
-// the helicopter faces the independent yaw reference signal.
+// Sets the last reference crossing value to the current yaw angle when the
+// helicopter faces the independent yaw reference signal.
+//
+//*****************************************************************************
+void setLastRefCrossing(bam_t yawAngle) {
+    lastRefCrossing = yawAngle;
+}
+
+
+//*****************************************************************************
+//
+// Sets the current height variable to the helicopters current altitude, as a
+// Q16 percentage.
 //
 //*****************************************************************************
-void setLastRefCrossing(int yawSlotCount) {
-    lastRefCrossing = yawSlotCount;
+void setCurrentHeight(q16_t height) {
+    currentHeight = height;
 }
 
 
 //*****************************************************************************
 //
-// Sets the current height variable to the helicopters current altitude, in
-// percent.
+// Sets the helicopters vertical velocity, as a Q16 percentage per second,
+// from an altitude estimator. Once set, the altitude derivative term uses it
+// instead of differencing the altitude error.
 //
 //*****************************************************************************
-void setCurrentHeight(int height) {
-    currentPercentHeight = height;
+void setCurrentHeightVelocity(q16_t velocity) {
+    heightVelocity = velocity;
+    heightVelocityValid = true;
 }
 
 
 //*****************************************************************************
 //
-// Sets the current yaw variable to the helicopters current yaw, in slots.
+// Sets the current yaw variable to the helicopters current yaw, as a binary
+// angle.
 //
 //*****************************************************************************
-void setCurrentYaw(int yaw) {
+void setCurrentYaw(bam_t yaw) {
     currentYaw = yaw;
 }
 
 
+//*****************************************************************************
+//
+// Sets the helicopters yaw rate, in Q16 slots per second, from the yaw rate
+// estimator. Once set, the yaw derivative term uses it instead of differencing
+// the yaw error.
+//
+//*****************************************************************************
+void setCurrentYawRate(q16_t rate) {
+    yawRate = rate;
+    yawRateValid = true;
+}
+
+
 //*****************************************************************************
 //
 // Decrements the reference height by 1%. Called when the current yaw is within
@@ -132,15 +344,24 @@ void setHeightManualLanding(int height) {
 //*****************************************************************************
 //
 // Increments the reference altitude by 10%.
+// The button handlers run in the main loop, so the control interrupt (and the
+// slider switch, which changes the mode) is held off from the mode check to
+// the store, and the new reference is stored once, already clamped.
 //
 //*****************************************************************************
 void setReferenceUp(void) {
+    uint32_t mask = IntPriorityMaskGet();
+    int height;
+
+    IntPriorityMaskSet(PRIORITY_CONTROL);
     if (currentMode == FLYING) {
-        referencePercentHeight += HEIGHT_STEP;
-        if (referencePercentHeight > MAX_HEIGHT) {
-            referencePercentHeight = MAX_HEIGHT;
+        height = referencePercentHeight + HEIGHT_STEP;
+        if (height > MAX_HEIGHT) {
+            height = MAX_HEIGHT;
         }
+        referencePercentHeight = height;
     }
+    IntPriorityMaskSet(mask);
 }
 
 
@@ -150,12 +371,18 @@ void setReferenceUp(void) {
 //
 //*****************************************************************************
 void setReferenceDown(void) {
+    uint32_t mask = IntPriorityMaskGet();
+    int height;
+
+    IntPriorityMaskSet(PRIORITY_CONTROL);
     if (currentMode == FLYING) {
-        referencePercentHeight -= HEIGHT_STEP;
-        if (referencePercentHeight < MIN_HEIGHT) {
-            referencePercentHeight = MIN_HEIGHT;
+        height = referencePercentHeight - HEIGHT_STEP;
+        if (height < MIN_HEIGHT) {
+            height = MIN_HEIGHT;
         }
+        referencePercentHeight = height;
     }
+    IntPriorityMaskSet(mask);
 }
 
 
@@ -165,9 +392,13 @@ void setReferenceDown(void) {
 //
 //*****************************************************************************
 void setReferenceCW(void) {
+    uint32_t mask = IntPriorityMaskGet();
+
+    IntPriorityMaskSet(PRIORITY_CONTROL);
     if (currentMode == FLYING) {
-        referenceYaw += YAW_STEP;
+        referenceYaw = referenceYaw + slotsToBam(YAW_STEP);
     }
+    IntPriorityMaskSet(mask);
 }
 
 
@@ -177,9 +408,13 @@ void setReferenceCW(void) {
 //
 //*****************************************************************************
 void setReferenceCCW(void) {
+    uint32_t mask = IntPriorityMaskGet();
+
+    IntPriorityMaskSet(PRIORITY_CONTROL);
     if (currentMode == FLYING) {
-        referenceYaw -= YAW_STEP;
+        referenceYaw = referenceYaw - slotsToBam(YAW_STEP);
     }
+    IntPriorityMaskSet(mask);
 }
 
 
@@ -188,7 +423,7 @@ void setReferenceCCW(void) {
 // Sets the reference yaw to the passed value.
 //
 //*****************************************************************************
-void setReferenceYaw(int yaw) {
+void setReferenceYaw(bam_t yaw) {
     referenceYaw = yaw;
 }
 
@@ -215,12 +450,24 @@ char* getMode(void) {
         return "Taking off";
     } else if (currentMode == FLYING) {
         return "Flying";
+    } else if (currentMode == AUTOTUNE) {
+        return "Autotune";
     } else {
         return "Landing";
     }
 }
 
 
+//*****************************************************************************
+//
+// Gets the current mode of the helicopter as a controlStates value.
+//
+//*****************************************************************************
+uint8_t getModeState(void) {
+    return currentMode;
+}
+
+
 //*****************************************************************************
 //
 // Sets the current mode of the helicopter.
@@ -237,7 +484,7 @@ void setMode(uint8_t mode) {
 //
 //*****************************************************************************
 int getErrorYaw(void) {
-    return yawError;
+    return Q16_TO_INT(yawError);
 }
 
 
@@ -247,7 +494,7 @@ int getErrorYaw(void) {
 //
 //*****************************************************************************
 int getErrorHeight(void) {
-    return heightError;
+    return Q16_TO_INT(heightError);
 }
 
 
@@ -266,7 +513,7 @@ int getReferenceHeight(void) {
 // Gets the reference yaw.
 //
 //*****************************************************************************
-int getReferenceYaw(void) {
+bam_t getReferenceYaw(void) {
     return referenceYaw;
 }
 
@@ -274,14 +521,12 @@ int getReferenceYaw(void) {
 //*****************************************************************************
 //
 // Finds the closest way to get to the last independent yaw reference crossing.
+// The yaw error wraps, so the reference angle itself is always reached the
+// shorter way round.
 //
 //*****************************************************************************
-int getClosestRef(void) {
-    if ((currentYaw - lastRefCrossing) < ((lastRefCrossing + TOTAL_SLOTS) - currentYaw)) {
-        return lastRefCrossing;
-    } else {
-        return lastRefCrossing + TOTAL_SLOTS;
-    }
+bam_t getClosestRef(void) {
+    return lastRefCrossing;
 }
 
 
@@ -289,28 +534,53 @@ int getClosestRef(void) {
 //
 // Performs PID control on the yaw by altering the tail rotor duty cycle.
 // The tail rotor duty cycle cannot exceed 98 percent, or go below 2 percent.
+// In the YAW_CONTROL_CASCADE mode this sets the yaw rate reference for the
+// inner loop instead.
 //
 //*****************************************************************************
 void updateYaw(void) {
-    yawError = referenceYaw - currentYaw; // yaw error signal
-    yawErrorIntegrated += yawError * DELTA_T; // integral of yaw error signal
-    yawErrorDerivative = (yawError - yawErrorPrevious) / DELTA_T; // derivative of error signal
-
-    yawErrorPrevious = yawError; // Store previous yaw error (for derivative control)
-
-    // Compute the PID control PWM value for the tail rotor
-    outputTail = (KpTail * yawError) + (KiTail * yawErrorIntegrated) + (KdTail * yawErrorDerivative);
-
-    // PWM duty cycle can't exceed 98%
-    if (outputTail > PWM_DUTY_MAX) {
-        outputTail = PWM_DUTY_MAX;
+    q16_t measuredRate;
+    q16_t profileYaw;
+    q16_t trackingError;
+
+    yawError = bamToSlotsQ16((int32_t)(referenceYaw - currentYaw)); // yaw error signal
+
+    // Aim the profile at a new reference, the shorter way round from where
+    // the profile is now
+    profileYaw = getTrajectoryPosition(&yawProfile);
+    if (referenceYaw != yawProfileReference) {
+        yawProfileReference = referenceYaw;
+        setTrajectoryTarget(&yawProfile,
+                            profileYaw + bamToSlotsQ16((int32_t)(referenceYaw - slotsQ16ToBam(profileYaw))));
     }
+    updateTrajectory(&yawProfile);
+    trackingError = bamToSlotsQ16((int32_t)(slotsQ16ToBam(getTrajectoryPosition(&yawProfile)) - currentYaw));
+
+    // The tail duty to follow the profile, applied by updateTailFeedforward()
+    tailProfileFeedforward = getTrajectoryFeedforward(&yawProfile, YAW_FF_VELOCITY,
+                                                      YAW_FF_ACCELERATION, YAW_FF_JERK);
+    tailIntegralHeld = (currentMode == FLYING) && isTrajectoryMoving(&yawProfile);
 
-    // PWM duty cycle can't go below 2%
-    if (outputTail < PWM_DUTY_MIN) {
-        outputTail = PWM_DUTY_MIN;
+    // Rate of the yaw, from the estimator or by differencing
+    if (yawRateValid) {
+        measuredRate = yawRate;
+    } else {
+        measuredRate = q16Mul(bamToSlotsQ16((int32_t)(currentYaw - previousYaw)), INT_TO_Q16(CONTROL_RATE_HZ));
     }
+    previousYaw = currentYaw;
+
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+    // Compute the yaw rate reference, with the profile velocity fed forward,
+    // the inner loop sets the tail rotor
+    setPIDFeedforward(&tailPID, getTrajectoryVelocity(&yawProfile));
+    yawRateReference = updatePID(&tailPID, trackingError, measuredRate);
+    yawRateLoopEnabled = true;
+#else
+    // Compute the PID control PWM value for the tail rotor, within 2% to 98%
+    outputTail = q16ToNearestInt(updatePID(&tailPID, trackingError,
+                                           q16Add(measuredRate, -getTrajectoryVelocity(&yawProfile))));
     setTailPWM(PWM_TAIL_START_RATE_HZ, outputTail);
+#endif
 }
 
 
@@ -322,7 +592,7 @@ void updateYaw(void) {
 //
 //*****************************************************************************
 bool canChangeMode(void) {
-    if (currentMode == LANDED || currentMode == FLYING) {
+    if (currentMode == LANDED || currentMode == FLYING || currentMode == AUTOTUNE) {
         return true;
     } else {
         return false;
@@ -337,19 +607,32 @@ bool canChangeMode(void) {
 //
 //*****************************************************************************
 void controlReset(void) {
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+    // Stop the inner loop before clearing its state
+    yawRateLoopEnabled = false;
+    yawRateReference = 0;
+    resetPID(&tailRatePID);
+#endif
     resetYawSlots();
 
+    // Keep what was learned in this flight, once the main loop gets to it
+    feedforwardSavePending = true;
+    steadyTicks = 0;
+
     referencePercentHeight = ZERO_HEIGHT;
-    currentPercentHeight = ZERO_HEIGHT;
+    currentHeight = ZERO_HEIGHT;
     heightError = ZERO_HEIGHT;
     yawError = ZERO_YAW;
     closestRef = ZERO_YAW;
-    yawErrorPrevious = ZERO_YAW;
-    heightErrorPrevious = ZERO_HEIGHT;
-    heightErrorIntegrated = ZERO_HEIGHT;
-    yawErrorIntegrated = ZERO_YAW;
-    heightErrorDerivative = ZERO_HEIGHT;
-    yawErrorDerivative = ZERO_YAW;
+    previousYaw = ZERO_YAW;
+    previousHeight = ZERO_HEIGHT;
+    resetPID(&mainPID);
+    resetPID(&tailPID);
+    resetTrajectory(&heightProfile, ZERO_HEIGHT);
+    resetTrajectory(&yawProfile, ZERO_YAW);
+    yawProfileReference = ZERO_YAW;
+    tailProfileFeedforward = 0;
+    tailIntegralHeld = false;
     outputMain = PWM_OFF;
     outputTail = PWM_OFF;
     referenceYaw = ZERO_YAW;
@@ -361,31 +644,85 @@ void controlReset(void) {
 
 //*****************************************************************************
 //
-// Performs PID control on the altitude by altering the main rotor duty cycle.
-// The main rotor duty cycle cannot exceed 98 percent, or go below 2 percent.
+// Sets the tail feedforward from the main rotor duty cycle and the yaw
+// profile, and holds the tail integrator while the profile moves. Once the
+// helicopter has hovered steadily for FF_STEADY_TICKS in the FLYING mode,
+// each tick moves part of the tail integrator into the feedforward table.
 //
 //*****************************************************************************
-void updateHeight(void) {
-    heightError = referencePercentHeight - currentPercentHeight; // height error signal
-    heightErrorIntegrated += heightError * DELTA_T; // height integral of error signal
-    heightErrorDerivative = (heightError - heightErrorPrevious) / DELTA_T; // derivative of error signal
-
-    heightErrorPrevious = heightError; // Store previous height error (for derivative control)
+static void updateTailFeedforward(void) {
+    q16_t mainDuty = INT_TO_Q16(outputMain);
+    q16_t learned = 0;
+    q16_t feedforward;
+    uint32_t mask;
 
-    // Compute the PID control PWM value for the main rotor
-    outputMain = (KpMain * heightError) + (KiMain * heightErrorIntegrated) + (KdMain * heightErrorDerivative);
+    if (currentMode == FLYING
+        && yawError < INT_TO_Q16(FF_STEADY_YAW_ERROR) && yawError > -INT_TO_Q16(FF_STEADY_YAW_ERROR)
+        && yawRate < INT_TO_Q16(FF_STEADY_YAW_RATE) && yawRate > -INT_TO_Q16(FF_STEADY_YAW_RATE)
+        && heightError < INT_TO_Q16(FF_STEADY_HEIGHT_ERROR) && heightError > -INT_TO_Q16(FF_STEADY_HEIGHT_ERROR)) {
+        if (steadyTicks < FF_STEADY_TICKS) {
+            steadyTicks++;
+        }
+    } else {
+        steadyTicks = 0;
+    }
 
-    // PWM duty cycle can't exceed 98%
-    if (outputMain > PWM_DUTY_MAX) {
-        outputMain = PWM_DUTY_MAX;
+    if (steadyTicks >= FF_STEADY_TICKS) {
+        learned = learnFeedforward(mainDuty, getPIDIntegral(tailDutyPID));
     }
+    feedforward = q16Add(getFeedforward(mainDuty), tailProfileFeedforward);
+
+    // The inner yaw rate loop interrupt also uses the tail controller
+    mask = IntPriorityMaskGet();
+    IntPriorityMaskSet(PRIORITY_YAW_RATE_LOOP);
+    adjustPIDIntegral(tailDutyPID, -learned);
+    setPIDFeedforward(tailDutyPID, feedforward);
+    holdPIDIntegral(tailDutyPID, tailIntegralHeld);
+    IntPriorityMaskSet(mask);
+}
+
 
-    // PWM duty cycle can't go below 2%
-    if (outputMain < PWM_DUTY_MIN) {
-        outputMain = PWM_DUTY_MIN;
+//*****************************************************************************
+//
+// Performs PID control on the altitude by altering the main rotor duty cycle.
+// The main rotor duty cycle cannot exceed 98 percent, or go below 2 percent.
+//
+//*****************************************************************************
+void updateHeight(void) {
+    q16_t measuredRate;
+    q16_t trackingError;
+
+    heightError = INT_TO_Q16(referencePercentHeight) - currentHeight; // height error signal
+
+    // Move the profile towards the reference
+    setTrajectoryTarget(&heightProfile, INT_TO_Q16(referencePercentHeight));
+    updateTrajectory(&heightProfile);
+    trackingError = getTrajectoryPosition(&heightProfile) - currentHeight;
+
+    // Feed forward the duty to follow the profile. When flying, hold the
+    // integrator while the profile moves so it only takes up the hover duty.
+    // Taking off and landing move the profile the whole time, and the
+    // integrator has to find the hover duty then.
+    setPIDFeedforward(&mainPID, getTrajectoryFeedforward(&heightProfile, HEIGHT_FF_VELOCITY,
+                                                         HEIGHT_FF_ACCELERATION, HEIGHT_FF_JERK));
+    holdPIDIntegral(&mainPID, (currentMode == FLYING) && isTrajectoryMoving(&heightProfile));
+
+    // Rate of the altitude, from the estimator or by differencing
+    if (heightVelocityValid) {
+        measuredRate = heightVelocity;
+    } else {
+        measuredRate = q16Mul(q16Add(currentHeight, -previousHeight), INT_TO_Q16(CONTROL_RATE_HZ));
     }
+    previousHeight = currentHeight;
+
+    // Compute the PID control PWM value for the main rotor, within 2% to 98%
+    outputMain = q16ToNearestInt(updatePID(&mainPID, trackingError,
+                                           q16Add(measuredRate, -getTrajectoryVelocity(&heightProfile))));
 
     setMainPWM(PWM_MAIN_START_RATE_HZ, outputMain);
+
+    // The tail duty follows the main duty
+    updateTailFeedforward();
 }
 
 
@@ -409,12 +746,159 @@ int getOutputTail(void) {
 }
 
 
+//*****************************************************************************
+//
+// Starts auto-tuning at the passed altitude reference. The buttons that start
+// it have already stepped the reference, so the caller passes the reference
+// from before the step. Called from the main loop, so the control interrupt
+// is held off while the reference, mode and stage are set.
+//
+//*****************************************************************************
+void startAutotune(int referenceHeight) {
+    uint32_t mask = IntPriorityMaskGet();
+
+    IntPriorityMaskSet(PRIORITY_CONTROL);
+    if (currentMode == FLYING) {
+        referencePercentHeight = referenceHeight;
+        tuneStage = TUNE_SETTLE;
+        tuneTicks = 0;
+        settledTicks = 0;
+        setMode(AUTOTUNE);
+    }
+    IntPriorityMaskSet(mask);
+}
+
+
+//*****************************************************************************
+//
+// Runs a tick of auto-tuning. First both controllers run until the altitude
+// has held within AUTOTUNE_SETTLE_HEIGHT_ERROR of the reference for
+// AUTOTUNE_SETTLE_TICKS, so the altitude relay is centred on the hover duty.
+// While the altitude is tuned the relay sets the
+// main duty and the yaw controller holds the yaw. Once the altitude gains are
+// found, the relay sets the tail duty, and the altitude is held with the new
+// gains. The relay on the tail acts on the yaw rate in the
+// YAW_CONTROL_CASCADE mode, with the inner loop stopped, or on the yaw
+// otherwise. The helicopter returns to FLYING when both are tuned, or if an
+// experiment fails or the altitude strays too far.
+//
+//*****************************************************************************
+static void updateAutotune(void) {
+    pidGains_t gains;
+
+    if (tuneStage == TUNE_SETTLE) {
+        updateYaw();
+        updateHeight();
+
+        tuneTicks++;
+        if (heightError < INT_TO_Q16(AUTOTUNE_SETTLE_HEIGHT_ERROR)
+            && heightError > -INT_TO_Q16(AUTOTUNE_SETTLE_HEIGHT_ERROR)) {
+            settledTicks++;
+        } else {
+            settledTicks = 0;
+        }
+
+        if (settledTicks >= AUTOTUNE_SETTLE_TICKS) {
+            tuneStage = TUNE_ALTITUDE;
+            startRelay(&relay, INT_TO_Q16(outputMain), AUTOTUNE_MAIN_RELAY, AUTOTUNE_MAIN_HYSTERESIS,
+                       CONTROL_RATE_HZ, AUTOTUNE_TIMEOUT_TICKS);
+        } else if (tuneTicks >= AUTOTUNE_TIMEOUT_TICKS) {
+            queueTuneResult("Altitude", 0, 0, NULL);
+            setMode(FLYING);
+        }
+        return;
+    } else if (tuneStage == TUNE_ALTITUDE) {
+        updateYaw();
+
+        heightError = INT_TO_Q16(referencePercentHeight) - currentHeight;
+        outputMain = q16ToNearestInt(updateRelay(&relay, heightError));
+        if (outputMain > PWM_DUTY_MAX) {
+            outputMain = PWM_DUTY_MAX;
+        } else if (outputMain < PWM_DUTY_MIN) {
+            outputMain = PWM_DUTY_MIN;
+        }
+        setMainPWM(PWM_MAIN_START_RATE_HZ, outputMain);
+        updateTailFeedforward();
+
+        if (getRelayState(&relay) == RELAY_DONE) {
+            calcRelayPID(&relay, &gains);
+            setMainTunedGains(&gains);
+            queueTuneResult("Altitude", getRelayKu(&relay), getRelayTu(&relay), &gains);
+
+            tuneStage = TUNE_YAW;
+            startRelay(&relay, INT_TO_Q16(outputTail), AUTOTUNE_TAIL_RELAY, AUTOTUNE_TAIL_HYSTERESIS,
+                       CONTROL_RATE_HZ, AUTOTUNE_TIMEOUT_TICKS);
+        }
+    } else {
+        updateHeight();
+
+        yawError = bamToSlotsQ16((int32_t)(referenceYaw - currentYaw));
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+        // Hold the yaw rate at zero
+        yawRateLoopEnabled = false;
+        outputTail = q16ToNearestInt(updateRelay(&relay, -yawRate));
+#else
+        outputTail = q16ToNearestInt(updateRelay(&relay, yawError));
+#endif
+        if (outputTail > PWM_DUTY_MAX) {
+            outputTail = PWM_DUTY_MAX;
+        } else if (outputTail < PWM_DUTY_MIN) {
+            outputTail = PWM_DUTY_MIN;
+        }
+        setTailPWM(PWM_TAIL_START_RATE_HZ, outputTail);
+
+        if (getRelayState(&relay) == RELAY_DONE) {
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+            calcRelayPI(&relay, &gains);
+#else
+            calcRelayPID(&relay, &gains);
+#endif
+            setTailTunedGains(&gains);
+            queueTuneResult("Yaw", getRelayKu(&relay), getRelayTu(&relay), &gains);
+            setMode(FLYING);
+        }
+    }
+
+    if (getRelayState(&relay) == RELAY_FAILED
+        || heightError > INT_TO_Q16(AUTOTUNE_HEIGHT_LIMIT) || heightError < -INT_TO_Q16(AUTOTUNE_HEIGHT_LIMIT)) {
+        queueTuneResult(tuneStage == TUNE_ALTITUDE ? "Altitude" : "Yaw", 0, 0, NULL);
+        setMode(FLYING);
+    }
+}
+
+
+//*****************************************************************************
+//
+// Sets the main and tail gains for the current mode and altitude.
+//
+//*****************************************************************************
+static void scheduleGains(void) {
+    pidGains_t gains;
+    uint32_t mask;
+
+    getMainGains(currentMode, currentHeight, &gains);
+    setPIDGains(&mainPID, &gains);
+
+    getTailGains(currentMode, currentHeight, &gains);
+
+    // The inner yaw rate loop interrupt also uses the tail controller
+    mask = IntPriorityMaskGet();
+    IntPriorityMaskSet(PRIORITY_YAW_RATE_LOOP);
+    setPIDGains(tailDutyPID, &gains);
+    IntPriorityMaskSet(mask);
+}
+
+
 //*****************************************************************************
 //
 // Updates the controller based on the helicopters current mode.
 //
 //*****************************************************************************
 void updateControl(void) {
+    if (currentMode != LANDED) {
+        scheduleGains();
+    }
+
     // Check the helicopters current mode
     switch (currentMode) {
         // If the mode is LANDING
@@ -424,12 +908,12 @@ void updateControl(void) {
                 updateYaw(); // Perform PID control on yaw
 
                 // Decrement the reference height by 1% if the yaw is within +/-5 slots of the reference
-                if ((closestRef < (currentYaw + LANDING_YAW_TOLERANCE)) && (closestRef > (currentYaw - LANDING_YAW_TOLERANCE))) {
+                if ((yawError < INT_TO_Q16(LANDING_YAW_TOLERANCE)) && (yawError > -INT_TO_Q16(LANDING_YAW_TOLERANCE))) {
                     setHeightManualLanding(LANDING_HEIGHT_DECREMENT);
                 }
 
                 // If the altitude is zero, reset control and set the mode to landed
-                if (currentPercentHeight == ZERO_HEIGHT) {
+                if (Q16_TO_INT(currentHeight) == ZERO_HEIGHT) {
                     controlReset();
                     setMode(LANDED);
                 }
@@ -449,9 +933,17 @@ void updateControl(void) {
                 updateHeight();
                 break;
 
+        // If the mode is auto-tuning
+        case (AUTOTUNE):
+                updateAutotune();
+                break;
+
         // If the mode is landed
         case (LANDED):
                 lastRefCrossing = ZERO_YAW;
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+                yawRateLoopEnabled = false;
+#endif
                 setMainPWM(PWM_MAIN_START_RATE_HZ, PWM_OFF);
                 setTailPWM(PWM_TAIL_START_RATE_HZ, PWM_OFF);
                 break;
@@ -6,7 +6,16 @@
 // control.c
 //
 // Implements PID controllers for the helicopter.
-// The controllers take altitude as a percentage, and yaw in slot counts.
+// The controllers take altitude as a Q16 percentage, and yaw in slot counts.
+// With YAW_CONTROL_CASCADE the yaw PID is an outer loop setting a yaw rate
+// reference, and an inner PI loop sets the tail duty from the yaw rate
+// error at YAW_RATE_LOOP_HZ. YAW_CONTROL_SINGLE drives the tail from one
+// yaw PID.
+// Interrupt layering (priorities.h), highest first: the quadrature edges, the
+// inner rate loop (TIMER3), then updateControl() (TIMER4 at
+// CONTROL_RATE_HZ with CONTROL_LOOP_TIMER, or the main loop with
+// CONTROL_LOOP_MAIN). Slow work (EEPROM, UART) is queued for
+// serviceControl() in the main loop.
 // This module uses getter functions so other modules can access control values,
 // and setter functions so other modules can alter control values.
 // Altitude control values are percentages of the maximum altitude.
@@ -18,6 +27,9 @@
 //
 //*****************************************************************************
 
+#include "fixedPoint.h"
+#include "yaw.h"
+
 #define HEIGHT_STEP 10                  // 10% altitude increments
 #define YAW_STEP 19                     // Corresponds to 15 deg
 
@@ -32,20 +44,125 @@
 #define LANDING_YAW_TOLERANCE 5         // Yaw error tolerance when landing
 #define LANDING_HEIGHT_DECREMENT 1
 
-#define DELTA_T 0.01                    // Period of control (100Hz)
+#define YAW_CONTROL_SINGLE 0
+#define YAW_CONTROL_CASCADE 1
+
+#ifndef YAW_CONTROL
+#define YAW_CONTROL YAW_CONTROL_CASCADE
+#endif
+
+#define CONTROL_LOOP_MAIN 0
+#define CONTROL_LOOP_TIMER 1
+
+#ifndef CONTROL_LOOP
+#define CONTROL_LOOP CONTROL_LOOP_TIMER
+#endif
+
+#define CONTROL_RATE_HZ 100             // Rate of control
+#define DELTA_T Q16(0.01)               // Period of control (100Hz), Q16 seconds
+
+// Inner yaw rate loop. The tail PWM runs at 200Hz, so faster updates would
+// mostly be lost between PWM periods.
+#define YAW_RATE_LOOP_HZ 500
+#define YAW_RATE_DELTA_T Q16(0.002)     // Period of the rate loop (500Hz), Q16 seconds
+#define YAW_RATE_REF_MAX 150            // Largest yaw rate reference, slots/s
+
+// Main rotor gains, Q16. These are the mid-altitude FLYING gains of the
+// schedule in gainSchedule.c.
+#define KpMain Q16(1.0)
+#define KiMain Q16(0.47)
+#define KdMain Q16(0.25)
+
+// Tail rotor gains, Q16
+#define KpTail Q16(1.0)
+#define KiTail Q16(0.18)
+#define KdTail Q16(0.22)
+
+// Cascaded yaw gains, Q16. The outer loop gives slots/s per slot of error,
+// the inner loop percent duty per slot/s of rate error.
+#define KpYaw Q16(5.0)
+#define KpTailRate Q16(0.8)
+#define KiTailRate Q16(2.0)
+
+// Steady hover for learning the tail feedforward
+#define FF_STEADY_TICKS 100             // Control ticks (1s) steady before learning
+#define FF_STEADY_YAW_ERROR 2           // Yaw error, slots
+#define FF_STEADY_YAW_RATE 5            // Yaw rate, slots/s
+#define FF_STEADY_HEIGHT_ERROR 2        // Altitude error, percent
+
+// Reference profiles, with velocity (per second) and acceleration (per
+// second squared) limits, and the ticks the acceleration takes to ramp.
+// The limits and the feedforward gains below were chosen with the host
+// simulation test/testReferenceProfile.c, on a plant model that was not
+// identified from the rig.
+#define HEIGHT_PROFILE_VELOCITY Q16(16.0)       // percent/s
+#define HEIGHT_PROFILE_ACCELERATION Q16(4.0)    // percent/s^2
+#define HEIGHT_PROFILE_JERK_TICKS 25
+#define YAW_PROFILE_VELOCITY Q16(100.0)         // slots/s
+#define YAW_PROFILE_ACCELERATION Q16(200.0)     // slots/s^2
+#define YAW_PROFILE_JERK_TICKS 25
+
+// Profile feedforward to the rotor duties, Q16 percent duty per unit/s,
+// per unit/s^2 and per unit/s^3. For a rotor whose thrust lags its duty
+// by tau, driving an axis with acceleration gain g and damping d, the
+// duty to follow the profile is (v d + a (1 + d tau) + j tau) / g. The
+// values are those of the model in test/heliPlant.h.
+#define HEIGHT_FF_VELOCITY Q16(0.5)
+#define HEIGHT_FF_ACCELERATION Q16(0.575)
+#define HEIGHT_FF_JERK Q16(0.075)
+#define YAW_FF_VELOCITY Q16(0.1)
+#define YAW_FF_ACCELERATION Q16(0.075)
+#define YAW_FF_JERK Q16(0.0053)
+
+// Relay auto-tuning
+#define AUTOTUNE_MAIN_RELAY Q16(8.0)        // Main duty step either side of the hover duty, percent
+#define AUTOTUNE_MAIN_HYSTERESIS Q16(0.5)   // Altitude, percent
+#define AUTOTUNE_TAIL_RELAY Q16(8.0)        // Tail duty step either side of the hover duty, percent
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+#define AUTOTUNE_TAIL_HYSTERESIS Q16(5.0)   // Yaw rate, slots/s
+#else
+#define AUTOTUNE_TAIL_HYSTERESIS Q16(1.0)   // Yaw, slots
+#endif
+#define AUTOTUNE_TIMEOUT_TICKS 3000         // Control ticks (30s) before an experiment fails
+#define AUTOTUNE_SETTLE_TICKS 200           // Control ticks (2s) settled before the altitude relay starts
+#define AUTOTUNE_SETTLE_HEIGHT_ERROR 1      // Altitude error counted as settled, percent
+#define AUTOTUNE_HEIGHT_LIMIT 25            // Altitude error that stops the tuning, percent
+
+// Derivative filter time constants, Q16 seconds
+#define HEIGHT_DERIVATIVE_TAU Q16(0.02)
+#define YAW_DERIVATIVE_TAU Q16(0.02)
 
-// Main rotor gains
-#define KpMain 1.0
-#define KiMain 0.47
-#define KdMain 0.25
+// States for the helicopter
+enum controlStates {LANDING=0, TAKINGOFF, FLYING, LANDED, AUTOTUNE};
 
-// Tail rotor gains
-#define KpTail 1.0
-#define KiTail 0.18
-#define KdTail 0.22
 
-// States for the helicopter
-enum controlStates {LANDING=0, TAKINGOFF, FLYING, LANDED};
+//*****************************************************************************
+//
+// Initialises the altitude and yaw PID controllers, loads the tail
+// feedforward table, and in the YAW_CONTROL_CASCADE mode starts the inner
+// yaw rate loop on TIMER3.
+//
+//*****************************************************************************
+void initControl(void);
+
+
+//*****************************************************************************
+//
+// Does the slow work queued by the controller: saves the feedforward table
+// after a landing, and sends auto-tuning results over UART. Called from the
+// main loop.
+//
+//*****************************************************************************
+void serviceControl(void);
+
+
+//*****************************************************************************
+//
+// Gets the longest run of the inner yaw rate loop interrupt, in system clock
+// cycles. Zero in the YAW_CONTROL_SINGLE mode.
+//
+//*****************************************************************************
+uint32_t getYawRateLoopCycles(void);
 
 
 //*****************************************************************************
@@ -59,28 +176,48 @@ void findIndependentYawReference(void);
 
 //*****************************************************************************
 //
-// Sets the last reference crossing value to the current yaw slot count when
-// the helicopter faces the independent yaw reference signal.
+// Sets the last reference crossing value to the current yaw angle when the
+// helicopter faces the independent yaw reference signal.
 //
 //*****************************************************************************
-void setLastRefCrossing(int yawSlotCount);
+void setLastRefCrossing(bam_t yawAngle);
 
 
 //*****************************************************************************
 //
-// Sets the current height variable to the helicopters current altitude, in
-// percent.
+// Sets the current height variable to the helicopters current altitude, as a
+// Q16 percentage.
 //
 //*****************************************************************************
-void setCurrentHeight(int height);
+void setCurrentHeight(q16_t height);
 
 
 //*****************************************************************************
 //
-// Sets the current yaw variable to the helicopters current yaw, in slots.
+// Sets the helicopters vertical velocity, as a Q16 percentage per second,
+// from an altitude estimator. Once set, the altitude derivative term uses it
+// instead of differencing the altitude error.
 //
 //*****************************************************************************
-void setCurrentYaw(int yaw);
+void setCurrentHeightVelocity(q16_t velocity);
+
+
+//*****************************************************************************
+//
+// Sets the current yaw variable to the helicopters current yaw, as a binary
+// angle.
+//
+//*****************************************************************************
+void setCurrentYaw(bam_t yaw);
+
+
+//*****************************************************************************
+//
+// Sets the helicopters yaw rate, in Q16 slots per second, from the yaw rate
+// estimator. Once set, the yaw derivative term uses it.
+//
+//*****************************************************************************
+void setCurrentYawRate(q16_t rate);
 
 
 //*****************************************************************************
@@ -130,7 +267,7 @@ void setReferenceCCW(void);
 // Sets the reference yaw to the passed value.
 //
 //*****************************************************************************
-void setReferenceYaw(int yaw);
+void setReferenceYaw(bam_t yaw);
 
 
 //*****************************************************************************
@@ -149,6 +286,14 @@ void setReferenceHeight(int height);
 char* getMode(void);
 
 
+//*****************************************************************************
+//
+// Gets the current mode of the helicopter as a controlStates value.
+//
+//*****************************************************************************
+uint8_t getModeState(void);
+
+
 //*****************************************************************************
 //
 // Sets the current mode of the helicopter.
@@ -186,7 +331,7 @@ int getReferenceHeight(void);
 // Gets the reference yaw.
 //
 //*****************************************************************************
-int getReferenceYaw(void);
+bam_t getReferenceYaw(void);
 
 
 //*****************************************************************************
@@ -194,7 +339,7 @@ int getReferenceYaw(void);
 // Finds the closest way to get to the last independent yaw reference crossing.
 //
 //*****************************************************************************
-int getClosestRef(void);
+bam_t getClosestRef(void);
 
 
 //*****************************************************************************
@@ -210,12 +355,23 @@ void updateYaw(void);
 //
 // Checks if the helicopter can change modes from a switch movement.
 // A switch movement cannot trigger a mode change if the helicopter is taking
-// off or landing.
+// off or landing. It can stop auto-tuning to land.
 //
 //*****************************************************************************
 bool canChangeMode(void);
 
 
+//*****************************************************************************
+//
+// Starts auto-tuning the altitude and yaw controllers, if the helicopter is
+// flying, at the passed altitude reference (percent). The buttons that start
+// it step the reference first, so the caller passes the reference from
+// before the step, and the altitude settles there before the relay starts.
+//
+//*****************************************************************************
+void startAutotune(int referenceHeight);
+
+
 //*****************************************************************************
 //
 // Resets the PID controller. Called when the helicopter is reaches the landed
@@ -0,0 +1,70 @@
+// *******************************************************
+//
+// decimator.c
+//
+// Fixed-point CIC (cascaded integrator-comb) decimation filter
+// for the oversampled altitude ADC samples.
+//
+// All arithmetic is modulo 2^32. The integrators overflow, but
+// the combs subtract the wrapped values again, so the output is
+// correct as long as it fits in the register width.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "decimator.h"
+
+
+//*****************************************************************************
+//
+// Clears the filter state.
+//
+//*****************************************************************************
+void initCicDecimator(cicDecimator_t *filter) {
+    uint8_t i;
+
+    for (i = 0; i < CIC_ORDER; i++) {
+        filter->integrator[i] = 0;
+        filter->delay[i] = 0;
+    }
+    filter->phase = 0;
+}
+
+
+//*****************************************************************************
+//
+// Adds one input sample. Every CIC_DECIMATION samples an output is written to
+// *output and true is returned, otherwise false is returned.
+//
+//*****************************************************************************
+bool cicDecimate(cicDecimator_t *filter, uint32_t sample, uint32_t *output) {
+    uint32_t value = sample;
+    uint32_t delayed;
+    uint8_t i;
+
+    // Integrator stages
+    for (i = 0; i < CIC_ORDER; i++) {
+        filter->integrator[i] += value;
+        value = filter->integrator[i];
+    }
+
+    filter->phase++;
+    if (filter->phase < CIC_DECIMATION) {
+        return false;
+    }
+    filter->phase = 0;
+
+    // Comb stages, at the decimated rate
+    for (i = 0; i < CIC_ORDER; i++) {
+        delayed = filter->delay[i];
+        filter->delay[i] = value;
+        value = value - delayed;
+    }
+
+    // Remove the DC gain, rounding to nearest
+    *output = (value + (1 << (CIC_GAIN_SHIFT - 1))) >> CIC_GAIN_SHIFT;
+    return true;
+}
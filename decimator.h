@@ -0,0 +1,65 @@
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+
+// *******************************************************
+//
+// decimator.c
+//
+// Fixed-point CIC (cascaded integrator-comb) decimation filter
+// for the oversampled altitude ADC samples.
+//
+// A CIC of order N and decimation R is N cascaded boxcar filters
+// of length R, computed with N integrators at the input rate and
+// N combs at the output rate. It needs no multiplies and has no
+// coefficient table. The DC gain is R^N, so with R a power of two
+// the output is scaled back with a shift that is worked out at
+// compile time.
+//
+// Group delay is N(R - 1)/2 input samples: 46.5 samples, or about
+// 14.5 ms at 3.2 kHz, compared with about 200 ms for the 40-sample
+// mean at 100 Hz.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CIC_ORDER 3
+#define CIC_LOG2_DECIMATION 5
+#define CIC_DECIMATION (1 << CIC_LOG2_DECIMATION)       // 32
+
+// Output scaling: divide by the DC gain R^N
+#define CIC_GAIN_SHIFT (CIC_ORDER * CIC_LOG2_DECIMATION)
+
+// 12-bit input plus the gain must fit in the 32-bit registers.
+// Intermediate overflow wraps and cancels in the combs.
+#if (12 + CIC_GAIN_SHIFT) > 32
+#error "CIC register width exceeded, reduce CIC_ORDER or CIC_DECIMATION"
+#endif
+
+typedef struct {
+    uint32_t integrator[CIC_ORDER];     // Integrator stages, run at the input rate
+    uint32_t delay[CIC_ORDER];          // Comb stage delays, run at the output rate
+    uint32_t phase;                     // Input samples since the last output
+} cicDecimator_t;
+
+
+//*****************************************************************************
+//
+// Clears the filter state.
+//
+//*****************************************************************************
+void initCicDecimator(cicDecimator_t *filter);
+
+
+//*****************************************************************************
+//
+// Adds one input sample. Every CIC_DECIMATION samples an output is written to
+// *output and true is returned, otherwise false is returned.
+//
+//*****************************************************************************
+bool cicDecimate(cicDecimator_t *filter, uint32_t sample, uint32_t *output);
+
+#endif /*DECIMATOR_H_*/
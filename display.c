@@ -68,7 +68,7 @@ void clearDisplay(void) {
 // Row 4 is the tail rotor PWM.
 //
 //*****************************************************************************
-void updateDisplay(uint8_t displayState,  uint16_t landedADCVal, uint16_t meanADCVal, int yawSlotCount) {
+void updateDisplay(uint8_t displayState,  uint16_t landedADCVal, uint16_t meanADCVal, bam_t yawAngle) {
     char string[OLED_STRING_BITS];
 
     // Display the altitude or clear display based on FSM state
@@ -87,7 +87,7 @@ void updateDisplay(uint8_t displayState,  uint16_t landedADCVal, uint16_t meanAD
     }
 
     // Display the yaw in degrees
-    usnprintf(string, sizeof(string), "Yaw = %5d ", calcYawDegrees(yawSlotCount));
+    usnprintf(string, sizeof(string), "Yaw = %5d ", calcYawDegrees(yawAngle));
     OLEDStringDraw(string, OLED_COL_ZERO, OLED_ROW_ONE);
 
     // Display the main and tail rotor PWM
@@ -15,6 +15,7 @@
 // *******************************************************
 
 #include <stdint.h>
+#include "yaw.h"
 
 enum displayStates {PERCENT=0, MEAN, OFF};
 
@@ -55,6 +56,6 @@ void clearDisplay(void);
 // Row 4 is the tail rotor PWM.
 //
 //*****************************************************************************
-void updateDisplay(uint8_t displayState,  uint16_t landedADCVal, uint16_t meanADCVal, int yawSlotCount);
+void updateDisplay(uint8_t displayState,  uint16_t landedADCVal, uint16_t meanADCVal, bam_t yawAngle);
 
 #endif /*DISPLAY_H_*/
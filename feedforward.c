@@ -0,0 +1,190 @@
+// *******************************************************
+//
+// feedforward.c
+//
+// Learned main rotor to tail rotor torque feedforward table,
+// saved in the EEPROM.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+#include "fixedPoint.h"
+#include "feedforward.h"
+
+// The table as it is saved in the EEPROM, a whole number of words
+typedef struct {
+    uint32_t magic;             // FF_EEPROM_MAGIC
+    uint32_t learned;           // Bit n is set once point n has been learned
+    q16_t table[FF_POINTS];     // Tail duty at each point, Q16 percent
+    uint32_t check;             // Check word over the fields above
+} feedforwardStore_t;
+
+static feedforwardStore_t store;
+static bool storeChanged;       // Set if learned since the last save
+
+
+//*****************************************************************************
+//
+// Calculates the check word over the saved fields.
+//
+//*****************************************************************************
+static uint32_t calcStoreCheck(void) {
+    uint32_t check = store.magic ^ store.learned;
+    int point;
+
+    for (point = 0; point < FF_POINTS; point++) {
+        check = (check << 1 | check >> 31) ^ (uint32_t) store.table[point];
+    }
+    return ~check;
+}
+
+
+//*****************************************************************************
+//
+// Enables the EEPROM and loads the saved table.
+//
+//*****************************************************************************
+void initFeedforward(void) {
+    int point;
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    if (EEPROMInit() == EEPROM_INIT_OK) {
+        EEPROMRead((uint32_t *) &store, FF_EEPROM_ADDRESS, sizeof(store));
+    }
+
+    if (store.magic != FF_EEPROM_MAGIC || store.check != calcStoreCheck()) {
+        store.magic = FF_EEPROM_MAGIC;
+        store.learned = 0;
+        for (point = 0; point < FF_POINTS; point++) {
+            store.table[point] = 0;
+        }
+    }
+    storeChanged = false;
+}
+
+
+//*****************************************************************************
+//
+// Finds the table point at or below the main duty, and the fraction of the
+// way to the next point, Q16.
+//
+//*****************************************************************************
+static int findPoint(q16_t mainDuty, q16_t *fraction) {
+    int point;
+
+    if (mainDuty < 0) {
+        mainDuty = 0;
+    }
+    mainDuty /= FF_STEP_DUTY;   // Now in Q16 table points
+
+    point = mainDuty >> Q16_SHIFT;
+    if (point >= FF_POINTS - 1) {
+        point = FF_POINTS - 2;
+        *fraction = Q16_ONE;
+    } else {
+        *fraction = mainDuty & (Q16_ONE - 1);
+    }
+    return point;
+}
+
+
+//*****************************************************************************
+//
+// Sets each point that has not been learned from the nearest learned point,
+// in proportion to the main duty.
+//
+//*****************************************************************************
+static void extrapolateUnlearned(void) {
+    int point;
+    int nearest;
+    int distance;
+
+    if (store.learned == 0) {
+        return;
+    }
+
+    for (point = 0; point < FF_POINTS; point++) {
+        if (store.learned & (1u << point)) {
+            continue;
+        }
+
+        // Search outwards for the nearest learned point
+        nearest = point;
+        for (distance = 1; distance < FF_POINTS; distance++) {
+            if (point - distance >= 0 && (store.learned & (1u << (point - distance)))) {
+                nearest = point - distance;
+                break;
+            }
+            if (point + distance < FF_POINTS && (store.learned & (1u << (point + distance)))) {
+                nearest = point + distance;
+                break;
+            }
+        }
+
+        if (nearest == 0) {
+            store.table[point] = store.table[0];
+        } else {
+            store.table[point] = (q16_t)((int64_t) store.table[nearest] * point / nearest);
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Returns the tail duty feedforward for the passed main duty.
+//
+//*****************************************************************************
+q16_t getFeedforward(q16_t mainDuty) {
+    q16_t fraction;
+    int point = findPoint(mainDuty, &fraction);
+
+    return q16Add(store.table[point],
+                  q16Mul(q16Add(store.table[point + 1], -store.table[point]), fraction));
+}
+
+
+//*****************************************************************************
+//
+// Moves the table towards the feedforward plus the residual, sharing the step
+// between the two points either side of the main duty by their interpolation
+// weights. The nearer point is marked as learned.
+//
+//*****************************************************************************
+q16_t learnFeedforward(q16_t mainDuty, q16_t residual) {
+    q16_t before = getFeedforward(mainDuty);
+    q16_t step = residual >> FF_LEARN_SHIFT;
+    q16_t fraction;
+    int point = findPoint(mainDuty, &fraction);
+
+    store.table[point] = q16Add(store.table[point], q16Mul(Q16_ONE - fraction, step));
+    store.table[point + 1] = q16Add(store.table[point + 1], q16Mul(fraction, step));
+    if (fraction <= Q16_ONE / 2) {
+        store.learned |= 1u << point;
+    } else {
+        store.learned |= 1u << (point + 1);
+    }
+    extrapolateUnlearned();
+    storeChanged = true;
+
+    return q16Add(getFeedforward(mainDuty), -before);
+}
+
+
+//*****************************************************************************
+//
+// Writes the table to the EEPROM if it has changed.
+//
+//*****************************************************************************
+void saveFeedforward(void) {
+    if (storeChanged) {
+        store.check = calcStoreCheck();
+        EEPROMProgram((uint32_t *) &store, FF_EEPROM_ADDRESS, sizeof(store));
+        storeChanged = false;
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef FEEDFORWARD_H_
+#define FEEDFORWARD_H_
+
+// *******************************************************
+//
+// feedforward.c
+//
+// Main rotor to tail rotor torque feedforward. A table gives
+// the tail duty needed to hold the yaw against the main rotor
+// torque at FF_POINTS main duties, FF_STEP_DUTY percent apart,
+// and is linearly interpolated in Q16.
+//
+// The table is learned online: while the helicopter hovers
+// steadily, the tail integrator holds what the feedforward is
+// missing, and learnFeedforward() moves that into the two
+// table points either side of the main duty. Points that have
+// not been learned are extrapolated from the nearest learned
+// point, taking the torque as proportional to the main duty.
+// Until the first point is learned the feedforward is zero.
+//
+// The table is kept in the EEPROM, so it persists across
+// resets. It is only written by saveFeedforward(), as a
+// program takes several milliseconds and wears the EEPROM.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+
+#define FF_POINTS 11                // Table points, at 0% to 100% main duty
+#define FF_STEP_DUTY 10             // Main duty between table points, percent
+#define FF_LEARN_SHIFT 6            // Each learning step moves 1/64 of the residual
+
+#define FF_EEPROM_ADDRESS 0x0       // Byte address of the saved table
+#define FF_EEPROM_MAGIC 0x46463031  // "FF01", marks a saved table
+
+
+//*****************************************************************************
+//
+// Enables the EEPROM and loads the saved table. The table is cleared if none
+// has been saved, or the saved table is corrupt.
+//
+//*****************************************************************************
+void initFeedforward(void);
+
+
+//*****************************************************************************
+//
+// Returns the tail duty feedforward for the passed main duty, both Q16
+// percent.
+//
+//*****************************************************************************
+q16_t getFeedforward(q16_t mainDuty);
+
+
+//*****************************************************************************
+//
+// Moves the table at the passed main duty towards the feedforward plus the
+// passed residual tail duty (the tail integrator in a steady hover). Returns
+// the change in the feedforward at that main duty, which should be taken off
+// the integrator so the tail duty does not step.
+//
+//*****************************************************************************
+q16_t learnFeedforward(q16_t mainDuty, q16_t residual);
+
+
+//*****************************************************************************
+//
+// Writes the table to the EEPROM if it has been learned since the last save.
+//
+//*****************************************************************************
+void saveFeedforward(void);
+
+#endif /*FEEDFORWARD_H_*/
@@ -0,0 +1,108 @@
+// *******************************************************
+//
+// fixedPoint.c
+//
+// Saturating Q16.16 arithmetic.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+
+
+//*****************************************************************************
+//
+// Adds two Q16 values, saturating at Q16_MAX and Q16_MIN. The sum overflowed
+// if both operands have the same sign and the sum has the other sign.
+//
+//*****************************************************************************
+q16_t q16Add(q16_t a, q16_t b) {
+    q16_t sum = (q16_t)((uint32_t) a + (uint32_t) b);
+
+    if (((a ^ sum) & (b ^ sum)) < 0) {
+        return (a < 0) ? Q16_MIN : Q16_MAX;
+    }
+    return sum;
+}
+
+
+//*****************************************************************************
+//
+// Multiplies two Q16 values, rounding to the nearest Q16 step and saturating
+// at Q16_MAX and Q16_MIN.
+//
+//*****************************************************************************
+q16_t q16Mul(q16_t a, q16_t b) {
+    int64_t product = ((int64_t) a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT;
+
+    if (product > Q16_MAX) {
+        return Q16_MAX;
+    }
+    if (product < Q16_MIN) {
+        return Q16_MIN;
+    }
+    return (q16_t) product;
+}
+
+
+//*****************************************************************************
+//
+// Divides two Q16 values, truncating towards zero and saturating at Q16_MAX
+// and Q16_MIN. The dividend is shifted up in 64 bits, so only the quotient
+// can overflow.
+//
+//*****************************************************************************
+q16_t q16Div(q16_t a, q16_t b) {
+    int64_t quotient;
+
+    if (b == 0) {
+        return (a < 0) ? Q16_MIN : Q16_MAX;
+    }
+    quotient = ((int64_t) a * Q16_ONE) / b;
+    if (quotient > Q16_MAX) {
+        return Q16_MAX;
+    }
+    if (quotient < Q16_MIN) {
+        return Q16_MIN;
+    }
+    return (q16_t) quotient;
+}
+
+
+//*****************************************************************************
+//
+// Converts a Q16 value to the nearest integer, halves away from zero.
+//
+//*****************************************************************************
+int32_t q16ToNearestInt(q16_t a) {
+    int64_t rounded = (int64_t) a + ((a >= 0) ? Q16_ONE / 2 : -Q16_ONE / 2);
+
+    return (int32_t)(rounded / Q16_ONE);
+}
+
+
+//*****************************************************************************
+//
+// Integer square root of a 64-bit value, rounded down, a bit at a time.
+//
+//*****************************************************************************
+uint32_t sqrt64(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t) 1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t) root;
+}
@@ -0,0 +1,83 @@
+#ifndef FIXEDPOINT_H_
+#define FIXEDPOINT_H_
+
+// *******************************************************
+//
+// fixedPoint.h
+//
+// Q16.16 signed fixed-point type and helpers. A q16_t holds
+// value * 65536 in an int32_t, giving a range of +/-32768 with
+// a resolution of about 0.000015.
+// q16Add() and q16Mul() saturate at Q16_MAX and Q16_MIN instead
+// of wrapping, so an overflow in a control loop drives the
+// output to its limit rather than flipping its sign.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE (1 << Q16_SHIFT)
+#define Q16_MAX INT32_MAX
+#define Q16_MIN INT32_MIN
+
+// Converts a constant (e.g. a gain literal) to Q16 at compile time
+#define Q16(x) ((q16_t)((x) * (double)Q16_ONE + ((x) >= 0 ? 0.5 : -0.5)))
+
+// Converts an integer to Q16
+#define INT_TO_Q16(x) ((q16_t)(x) * Q16_ONE)
+
+// Converts Q16 to an integer, truncating towards zero like integer division
+#define Q16_TO_INT(x) ((int32_t)((x) / Q16_ONE))
+
+
+
+//*****************************************************************************
+//
+// Adds two Q16 values, saturating at Q16_MAX and Q16_MIN.
+//
+//*****************************************************************************
+q16_t q16Add(q16_t a, q16_t b);
+
+
+//*****************************************************************************
+//
+// Multiplies two Q16 values, rounding to the nearest Q16 step and saturating
+// at Q16_MAX and Q16_MIN.
+//
+//*****************************************************************************
+q16_t q16Mul(q16_t a, q16_t b);
+
+
+//*****************************************************************************
+//
+// Divides two Q16 values, truncating towards zero like integer division and
+// saturating at Q16_MAX and Q16_MIN. Division by zero saturates to the sign
+// of the dividend.
+//
+//*****************************************************************************
+q16_t q16Div(q16_t a, q16_t b);
+
+
+//*****************************************************************************
+//
+// Converts a Q16 value to the nearest integer, halves away from zero. Unlike
+// Q16_TO_INT it does not bias the result towards zero.
+//
+//*****************************************************************************
+int32_t q16ToNearestInt(q16_t a);
+
+
+//*****************************************************************************
+//
+// Integer square root of a 64-bit value, rounded down. The square root of a
+// Q32 value is Q16.
+//
+//*****************************************************************************
+uint32_t sqrt64(uint64_t value);
+
+#endif /*FIXEDPOINT_H_*/
@@ -0,0 +1,181 @@
+// *******************************************************
+//
+// gainSchedule.c
+//
+// Altitude and mode scheduled PID gains for the main and tail
+// rotors.
+//
+// The middle altitudes in the FLYING mode use the gains in
+// control.h. Near the ground the ground effect adds lift and
+// damping, so the main rotor gains are softer there, most of
+// all when landing so the helicopter does not bounce. Taking
+// off has more proportional gain near the ground to lift off
+// promptly. At the top of the range the rotor is near its
+// maximum duty and the response is slower, so the gains are
+// raised. The tail gains follow the main rotor, whose speed
+// changes how well the tail holds the yaw.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+#include "pid.h"
+#include "control.h"
+#include "gainSchedule.h"
+
+// Main rotor gains, by mode then altitude 0%, 25%, 50%, 75%, 100%
+static const pidGains_t mainGainTable[GS_MODES][GS_POINTS] = {
+    // LANDING
+    {{Q16(0.6), Q16(0.30), Q16(0.30)}, {Q16(0.8), Q16(0.40), Q16(0.28)},
+     {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}},
+    // TAKINGOFF
+    {{Q16(1.2), Q16(0.30), Q16(0.25)}, {Q16(1.1), Q16(0.40), Q16(0.25)},
+     {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}},
+    // FLYING
+    {{Q16(0.8), Q16(0.40), Q16(0.30)}, {KpMain, KiMain, KdMain},
+     {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}, {Q16(1.2), Q16(0.55), Q16(0.25)}},
+    // LANDED, the controller is not run
+    {{KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain},
+     {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}, {KpMain, KiMain, KdMain}},
+};
+
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+#define TAIL_BASE_GAINS {KpTailRate, KiTailRate, 0}
+#define TAIL_LOW_GAINS {Q16(0.7), Q16(1.6), 0}
+#define TAIL_HIGH_GAINS {Q16(0.9), Q16(2.2), 0}
+#else
+#define TAIL_BASE_GAINS {KpTail, KiTail, KdTail}
+#define TAIL_LOW_GAINS {Q16(0.9), Q16(0.15), Q16(0.22)}
+#define TAIL_HIGH_GAINS {Q16(1.1), Q16(0.20), Q16(0.22)}
+#endif
+
+// Tail rotor gains, by mode then altitude 0%, 25%, 50%, 75%, 100%
+static const pidGains_t tailGainTable[GS_MODES][GS_POINTS] = {
+    // LANDING
+    {TAIL_LOW_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_HIGH_GAINS},
+    // TAKINGOFF
+    {TAIL_LOW_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_HIGH_GAINS},
+    // FLYING
+    {TAIL_LOW_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_HIGH_GAINS},
+    // LANDED, the controller is not run
+    {TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS, TAIL_BASE_GAINS},
+};
+
+// Scale of the tuned gains to the table gains, Q16
+static pidGains_t mainScale = {Q16_ONE, Q16_ONE, Q16_ONE};
+static pidGains_t tailScale = {Q16_ONE, Q16_ONE, Q16_ONE};
+
+
+//*****************************************************************************
+//
+// Finds the scale of a tuned gain to a table gain. A gain that is zero in the
+// table keeps a scale of one. A scale too large for Q16 (a tuned gain more
+// than about 32768 times the table gain) saturates.
+//
+//*****************************************************************************
+static q16_t calcScale(q16_t table, q16_t tuned) {
+    if (table == 0) {
+        return Q16_ONE;
+    }
+    return q16Div(tuned, table);
+}
+
+
+//*****************************************************************************
+//
+// Finds the table row for a mode. AUTOTUNE has no row of its own: the axis
+// not under test is held by its FLYING gains.
+//
+//*****************************************************************************
+static uint8_t getTableRow(uint8_t mode) {
+    switch (mode) {
+    case LANDING:
+    case TAKINGOFF:
+    case FLYING:
+    case LANDED:
+        return mode;
+    case AUTOTUNE:
+    default:
+        return FLYING;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Interpolates the gains in a table row at the passed altitude, and scales
+// them by any tuning.
+//
+//*****************************************************************************
+static void interpolateGains(const pidGains_t *row, const pidGains_t *scale,
+                             q16_t height, pidGains_t *gains) {
+    int point;
+    q16_t fraction;
+
+    if (height < 0) {
+        height = 0;
+    }
+    height /= GS_STEP_HEIGHT;   // Now in Q16 table points
+
+    point = height >> Q16_SHIFT;
+    if (point >= GS_POINTS - 1) {
+        point = GS_POINTS - 2;
+        fraction = Q16_ONE;
+    } else {
+        fraction = height & (Q16_ONE - 1);
+    }
+
+    gains->kp = q16Mul(row[point].kp + q16Mul(row[point + 1].kp - row[point].kp, fraction), scale->kp);
+    gains->ki = q16Mul(row[point].ki + q16Mul(row[point + 1].ki - row[point].ki, fraction), scale->ki);
+    gains->kd = q16Mul(row[point].kd + q16Mul(row[point + 1].kd - row[point].kd, fraction), scale->kd);
+}
+
+
+//*****************************************************************************
+//
+// Gets the main rotor gains for the passed mode and altitude.
+//
+//*****************************************************************************
+void getMainGains(uint8_t mode, q16_t height, pidGains_t *gains) {
+    interpolateGains(mainGainTable[getTableRow(mode)], &mainScale, height, gains);
+}
+
+
+//*****************************************************************************
+//
+// Gets the tail duty controller gains for the passed mode and altitude.
+//
+//*****************************************************************************
+void getTailGains(uint8_t mode, q16_t height, pidGains_t *gains) {
+    interpolateGains(tailGainTable[getTableRow(mode)], &tailScale, height, gains);
+}
+
+
+//*****************************************************************************
+//
+// Sets tuned main rotor gains, as a scale on the whole table.
+//
+//*****************************************************************************
+void setMainTunedGains(const pidGains_t *tuned) {
+    const pidGains_t *base = &mainGainTable[FLYING][GS_POINTS / 2];
+
+    mainScale.kp = calcScale(base->kp, tuned->kp);
+    mainScale.ki = calcScale(base->ki, tuned->ki);
+    mainScale.kd = calcScale(base->kd, tuned->kd);
+}
+
+
+//*****************************************************************************
+//
+// Sets tuned tail duty controller gains, as a scale on the whole table.
+//
+//*****************************************************************************
+void setTailTunedGains(const pidGains_t *tuned) {
+    const pidGains_t *base = &tailGainTable[FLYING][GS_POINTS / 2];
+
+    tailScale.kp = calcScale(base->kp, tuned->kp);
+    tailScale.ki = calcScale(base->ki, tuned->ki);
+    tailScale.kd = calcScale(base->kd, tuned->kd);
+}
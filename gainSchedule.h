@@ -0,0 +1,71 @@
+#ifndef GAINSCHEDULE_H_
+#define GAINSCHEDULE_H_
+
+// *******************************************************
+//
+// gainSchedule.c
+//
+// Altitude and mode scheduled PID gains for the main and tail
+// rotors. Each rotor has a table of gains at GS_POINTS
+// altitudes, GS_STEP_HEIGHT percent apart, for each mode of
+// the helicopter. The gains are linearly interpolated between
+// the two altitudes either side of the current one, which is
+// one divide and six Q16 multiplies for each rotor,
+// including the tuning scale.
+//
+// Gains found by auto-tuning replace the mid-altitude FLYING
+// gains, and the rest of the table is scaled with them. They
+// are kept in RAM only, so a reset returns to the tables.
+//
+// The tail table holds the gains of whichever controller sets
+// the tail duty, the inner yaw rate loop in the
+// YAW_CONTROL_CASCADE mode or the yaw PID otherwise.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+#include "pid.h"
+
+#define GS_POINTS 5                 // Table points, at 0% to 100% altitude
+#define GS_STEP_HEIGHT 25           // Altitude between table points, percent
+#define GS_MODES 4                  // Table rows, LANDING to LANDED; AUTOTUNE uses FLYING
+
+
+//*****************************************************************************
+//
+// Gets the main rotor gains for the passed mode (a controlStates value) and
+// altitude (Q16 percent).
+//
+//*****************************************************************************
+void getMainGains(uint8_t mode, q16_t height, pidGains_t *gains);
+
+
+//*****************************************************************************
+//
+// Gets the gains of the controller that sets the tail duty for the passed
+// mode and altitude.
+//
+//*****************************************************************************
+void getTailGains(uint8_t mode, q16_t height, pidGains_t *gains);
+
+
+//*****************************************************************************
+//
+// Sets tuned main rotor gains, for the middle altitude in the FLYING mode.
+//
+//*****************************************************************************
+void setMainTunedGains(const pidGains_t *tuned);
+
+
+//*****************************************************************************
+//
+// Sets tuned gains for the controller that sets the tail duty, for the middle
+// altitude in the FLYING mode.
+//
+//*****************************************************************************
+void setTailTunedGains(const pidGains_t *tuned);
+
+#endif /*GAINSCHEDULE_H_*/
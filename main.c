@@ -31,6 +31,8 @@
 #include "driverlib/debug.h"
 #include "driverlib/pwm.h"
 #include "driverlib/pin_map.h"
+#include "driverlib/timer.h"
+#include "inc/hw_ints.h"
 #include "utils/ustdlib.h"
 
 // Provided OrbitBoosterBoard Lib
@@ -39,6 +41,9 @@
 // Libs created as part of the project
 #include "buttons4.h"
 #include "circBufT.h"
+#include "spscBufT.h"
+#include "adcSampler.h"
+#include "slidingMedian.h"
 #include "display.h"
 #include "userInput.h"
 #include "yaw.h"
@@ -46,41 +51,85 @@
 #include "pwm.h"
 #include "control.h"
 #include "altitude.h"
+#include "altitudeKalman.h"
+#include "timestamp.h"
+#include "priorities.h"
 
 //*****************************************************************************
 // Constants
 //*****************************************************************************
-#define BUFFER_FILL_DELAY 6
-#define BUF_SIZE 40
+#define BUF_SIZE ADC_MEAN_WINDOW
+#define ADC_RING_SIZE 64        // Must be a power of two
+#define ADC_DRAIN_CHUNK 16
+
+// Altitude sample filter, chosen at build time with ALTITUDE_FILTER
+#define ALTITUDE_FILTER_MEAN 0      // Mean of the last BUF_SIZE samples
+#define ALTITUDE_FILTER_MEDIAN 1    // Median of the last MEDIAN_WINDOW samples
+#define ALTITUDE_FILTER_HAMPEL 2    // Mean, with samples far from the median replaced by it
+#ifndef ALTITUDE_FILTER
+#define ALTITUDE_FILTER ALTITUDE_FILTER_MEAN
+#endif
+#define MEDIAN_WINDOW 15
+#define HAMPEL_THRESHOLD 40         // ADC counts (about 4% altitude)
+
+// Altitude estimator, chosen at build time with ALTITUDE_ESTIMATOR
+#define ALTITUDE_ESTIMATOR_FILTER 0 // Altitude from the filtered ADC value
+#define ALTITUDE_ESTIMATOR_KALMAN 1 // Altitude and velocity from the Kalman filter
+#ifndef ALTITUDE_ESTIMATOR
+#define ALTITUDE_ESTIMATOR ALTITUDE_ESTIMATOR_FILTER
+#endif
+
+// Landed calibration ends once the variance of the mean of the landed
+// samples (variance / count) is below CALIBRATION_TOLERANCE (a standard
+// error of 0.5 ADC counts), or after CALIBRATION_MAX_SAMPLES samples.
+#define CALIBRATION_MIN_SAMPLES 8
+#define CALIBRATION_MAX_SAMPLES 150
+#define CALIBRATION_TOLERANCE Q16(0.25)
+
+#define NOISE_STATS_BLOCK 200       // Samples per reported noise variance
+#define LANDED_DRIFT_SHIFT 10       // Landed reference follows 1/1024 of the error per update
+#define LANDED_DRIFT_HALF (1 << (LANDED_DRIFT_SHIFT - 1))
+
+#define Q8_SHIFT 8
+#define Q8_HALF (1 << (Q8_SHIFT - 1))
 
 #define SAMPLE_RATE_HZ 100
 
 #define UART_SEND_PERIOD 25
 #define DISPLAY_PERIOD 25
 
-#define CHANNEL_A GPIO_PIN_0
-#define CHANNEL_B GPIO_PIN_1
+#define PERIOD_STATS_BLOCK 500   // Control periods (5s) per reported period statistics
 
 #define FLAG_CLEAR 0
 #define FLAG_SET 1
 #define FLAG_COUNT_ZERO 0
 
-#define ADC_SEQUENCE_THREE 3
-#define ADC_CHANNEL_ZERO 0
-
 //*****************************************************************************
 // Global variables
 //*****************************************************************************
-static circBuf_t g_inBuffer;		 // Buffer of size BUF_SIZE integers (sample values)
+CIRCBUF_STATIC(g_inBuffer, BUF_SIZE); // Buffer of size BUF_SIZE integers (sample values)
+static spscBuf_t g_adcRing;          // Lock-free hand over of samples from the ADC ISR
+static uint32_t g_adcRingStorage[ADC_RING_SIZE];
+static adcStats_t g_adcStats;        // Raw ADC statistics for the current block
+static q16_t g_noiseVariance;        // Raw ADC variance over the last full block
+#if ALTITUDE_FILTER != ALTITUDE_FILTER_MEAN
+SLIDING_MEDIAN_STATIC(g_medianFilter, MEDIAN_WINDOW); // Running median of the samples
+#endif
 static uint32_t g_ulDispCnt;	     // Counter for display interrupts
 static uint32_t g_ulUARTCnt;         // Counter to trigger a UART send
 static uint8_t displayFlag;          // Flag for refreshing display
+#if CONTROL_LOOP == CONTROL_LOOP_MAIN
 static uint8_t controlUpdateFlag;    // Flag for refreshing control system
+#endif
 static uint8_t UARTFlag;             // Flag for UART sending
 static uint8_t buttonFlag;           // Flag for button polling
-static int currentYawState;          // The current state of the yaw sensors
-static int previousYawState;         // The previous state of the yaw sensors
-int yawSlotCount = 0;  // Init the yaw slot to the zero value
+static uint16_t g_landedADCVal;      // ADC value at zero altitude
+static uint32_t g_landedADCValQ16;   // ADC value at zero altitude, Q16
+static uint16_t g_meanADCVal;        // Filtered ADC value
+static uint32_t g_meanADCValQ8;      // Filtered ADC value, Q8
+static periodStats_t g_controlPeriod;       // Periods between control steps in this block
+static periodStats_t g_controlPeriodReport; // Statistics of the last full block
+static volatile uint8_t periodFlag;  // Flag for sending the period statistics
 
 
 //*****************************************************************************
@@ -90,8 +139,14 @@ int yawSlotCount = 0;  // Init the yaw slot to the zero value
 //*****************************************************************************
 void
 SysTickIntHandler(void) {
-    // Initiate a conversion
-    ADCProcessorTrigger(ADC0_BASE, ADC_SEQUENCE_THREE);
+    // Initiate a conversion (the hardware timer does this in the uDMA mode)
+    triggerADCSample();
+
+    // Measure the yaw rate over the last tick (the inner yaw rate loop does
+    // this in the cascade mode, and the control interrupt in the timer mode)
+#if YAW_CONTROL == YAW_CONTROL_SINGLE && CONTROL_LOOP == CONTROL_LOOP_MAIN
+    updateYawRate();
+#endif
 
     g_ulDispCnt++;
     g_ulUARTCnt++;
@@ -99,8 +154,11 @@ SysTickIntHandler(void) {
     // Set the flag for button polling
     buttonFlag = FLAG_SET;
 
-    // Set the flag for the PID controller
+    // Set the flag for the PID controller (the control interrupt runs it in
+    // the timer mode)
+#if CONTROL_LOOP == CONTROL_LOOP_MAIN
     controlUpdateFlag = FLAG_SET;
+#endif
 
     // Set the flag for display refreshing every 25 SysTick interrupts (250ms)
     if (g_ulDispCnt >= DISPLAY_PERIOD) {
@@ -116,56 +174,6 @@ SysTickIntHandler(void) {
 }
 
 
-//*****************************************************************************
-//
-// The handler for the ADC conversion complete interrupt.
-// Writes to the circular buffer.
-//
-//*****************************************************************************
-void
-ADCIntHandler(void) {
-	uint32_t ulValue;
-	
-	// Get the single sample from ADC0.  ADC_BASE is defined in
-	// inc/hw_memmap.h
-	ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCE_THREE, &ulValue);
-
-	// Place it in the circular buffer (advancing write index)
-	writeCircBuf(&g_inBuffer, ulValue);
-
-	// Clean up, clearing the interrupt
-	ADCIntClear(ADC0_BASE, ADC_SEQUENCE_THREE);
-}
-
-
-//*****************************************************************************
-//
-// The interrupt handler for the quadrature decoding module.
-// The interrupt is triggered by pin changes (edges) on PB0 and PB1.
-//
-//*****************************************************************************
-void
-quadratureIntHandler(void) {
-    GPIOIntClear(GPIO_PORTB_BASE, GPIO_INT_PIN_0 | GPIO_INT_PIN_1); // Clear the interrupt
-
-    previousYawState = currentYawState; // Save the previous state
-
-    // Read the values on PB0 and PB1
-    // The yaw signals are on pins 0 and 1. GPIOPinRead returns a bit packed
-    // byte where the zeroth bit is the state of pin 0, the first bit is the state 
-    // of pin 1 on the port, etc. Bits two to seven are not read by the quadrature decoder,
-    // and hence their bit in the returned byte is zero. So PB0 low and PB1 low returns 0x00
-    // when read, PB0 high and PB1 low returns 0x01 when read etc. The returned value will 
-    // therefore match the desired state as given in the yawStates enum (yaw.h)
-    currentYawState = (int) GPIOPinRead(GPIO_PORTB_BASE, CHANNEL_A | CHANNEL_B);
-
-    // Determine the direction of rotation. Increment or decrement yawSlotCount appropriately.
-    quadratureDecode(&yawSlotCount, currentYawState, previousYawState);
-
-    setCurrentYaw(yawSlotCount);
-}
-
-
 //*****************************************************************************
 //
 // The interrupt handler for the independent yaw reference signal.
@@ -175,8 +183,10 @@ quadratureIntHandler(void) {
 void yawRefSignalIntHandler(void) {
     GPIOIntClear(GPIO_PORTC_BASE, GPIO_INT_PIN_4); // Clear the interrupt
     
-    // Set the last reference crossing value to the current yaw slot count
-    setLastRefCrossing(yawSlotCount);
+    // Correct the yaw for any drift since the last crossing, then set the
+    // last reference crossing value to the current yaw
+    yawReferenceCrossed();
+    setLastRefCrossing(getYawAngle());
 }
 
 
@@ -228,71 +238,6 @@ initClock(void) {
 }
 
 
-//*****************************************************************************
-//
-// Initialisation for the ADC.
-//
-//*****************************************************************************
-void 
-initADC(void) {
-
-    // The ADC0 peripheral must be enabled for configuration and use.
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
-    
-    // Enable sample sequence 3 with a processor signal trigger.  Sequence 3
-    // will do a single sample when the processor sends a signal to start the
-    // conversion.
-    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_TRIGGER_PROCESSOR, ADC_CHANNEL_ZERO);
-  
-
-    // Configure step 0 on sequence 3.  Sample channel 0 (ADC_CTL_CH0) in
-    // single-ended mode (default) and configure the interrupt flag
-    // (ADC_CTL_IE) to be set when the sample is done.  Tell the ADC logic
-    // that this is the last conversion on sequence 3 (ADC_CTL_END).  Sequence
-    // 3 has only one programmable step.  Sequence 1 and 2 have 4 steps, and
-    // sequence 0 has 8 programmable steps.  Since we are only doing a single
-    // conversion using sequence 3 we will only configure step 0.  For more
-    // on the ADC sequences and steps, refer to the LM3S1968 datasheet.
-    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCE_THREE, ADC_CHANNEL_ZERO, ADC_CTL_CH9 | ADC_CTL_IE |
-                             ADC_CTL_END);    
-                             
-    // Since sample sequence 3 is now configured, it must be enabled.
-    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
-  
-    // Register the interrupt handler
-    ADCIntRegister(ADC0_BASE, ADC_SEQUENCE_THREE, ADCIntHandler);
-  
-    // Enable interrupts for ADC0 sequence 3 (clears any outstanding interrupts)
-    ADCIntEnable(ADC0_BASE, ADC_SEQUENCE_THREE);
-}
-
-
-//*****************************************************************************
-//
-// Initialisation for the quadrature peripherals (GPIOs PB0 and PB1).
-//
-//*****************************************************************************
-void
-quadratureInitialise(void) {
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB); // Enable Port B
-
-    // Set PB0 and PB1 as inputs
-    GPIOPinTypeGPIOInput(GPIO_PORTB_BASE, CHANNEL_A | CHANNEL_B);
-
-    // Enable interrupts on PB0 and PB1
-    GPIOIntEnable(GPIO_PORTB_BASE, GPIO_INT_PIN_0 | GPIO_INT_PIN_1);
-
-    // Set interrupts on PB0 and PB1 as pin change interrupts
-    GPIOIntTypeSet(GPIO_PORTB_BASE, CHANNEL_A | CHANNEL_B, GPIO_BOTH_EDGES);
-
-    // Register the interrupt handler
-    GPIOIntRegister(GPIO_PORTB_BASE, quadratureIntHandler);
-
-    // Read the values on PB0 and PB1
-    currentYawState = GPIOPinRead(GPIO_PORTB_BASE, CHANNEL_A | CHANNEL_B);
-}
-
-
 //*****************************************************************************
 //
 // Initialisation for the independent yaw reference.
@@ -342,32 +287,250 @@ void initSliderSwitch(void) {
 }
 
 
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_HAMPEL
 //*****************************************************************************
 //
-// Sets the yaw slot count to zero.
+// Adds the sample to the running median and returns it, or returns the
+// median instead if the sample is more than HAMPEL_THRESHOLD from it.
 //
 //*****************************************************************************
-void resetYawSlots(void) {
-    yawSlotCount = 0;
+uint32_t rejectOutlier(uint32_t sample) {
+    uint32_t median;
+
+    insertSlidingMedian(&g_medianFilter, sample);
+    median = getSlidingMedian(&g_medianFilter);
+
+    if (sample > median + HAMPEL_THRESHOLD || sample + HAMPEL_THRESHOLD < median) {
+        return median;
+    }
+    return sample;
+}
+#endif
+
+
+//*****************************************************************************
+//
+// Moves any new samples from the ADC sample ring into the averaging buffer
+// (and the median filter and Kalman filter, if used), and adds them to the
+// noise statistics. Returns the number of samples moved.
+// Only the main loop calls this, so it is the single consumer of the ring.
+//
+//*****************************************************************************
+uint32_t drainADCSamples(void) {
+    uint32_t samples[ADC_DRAIN_CHUNK];
+    uint32_t count;
+    uint32_t total = 0;
+    uint32_t i;
+
+    do {
+        count = readSpscBuf(&g_adcRing, samples, ADC_DRAIN_CHUNK);
+        for (i = 0; i < count; i++) {
+            updateADCStats(&g_adcStats, samples[i]);
+            if (g_adcStats.count >= NOISE_STATS_BLOCK) {
+                g_noiseVariance = getADCStatsVariance(&g_adcStats);
+                resetADCStats(&g_adcStats);
+            }
+        }
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_HAMPEL
+        for (i = 0; i < count; i++) {
+            samples[i] = rejectOutlier(samples[i]);
+        }
+#elif ALTITUDE_FILTER == ALTITUDE_FILTER_MEDIAN
+        for (i = 0; i < count; i++) {
+            insertSlidingMedian(&g_medianFilter, samples[i]);
+        }
+#endif
+#if ALTITUDE_ESTIMATOR == ALTITUDE_ESTIMATOR_KALMAN
+        for (i = 0; i < count; i++) {
+            updateAltitudeKalman(samples[i], getOutputMain());
+        }
+#endif
+        writeCircBufBulk(&g_inBuffer, samples, count);
+        total += count;
+    } while (count == ADC_DRAIN_CHUNK);
+
+    return total;
+}
+
+
+//*****************************************************************************
+//
+// Returns true once enough landed samples have been collected that their
+// mean is within the calibration tolerance, judged from the sample variance.
+//
+//*****************************************************************************
+bool isLandedCalibrated(void) {
+    uint32_t count = g_adcStats.count;
+
+    if (count < CALIBRATION_MIN_SAMPLES) {
+        return false;
+    }
+    if (count >= CALIBRATION_MAX_SAMPLES) {
+        return true;
+    }
+    return getADCStatsVariance(&g_adcStats) <= CALIBRATION_TOLERANCE * (int32_t) count;
+}
+
+
+//*****************************************************************************
+//
+// Returns the filtered ADC value used for the altitude, with 8 fractional
+// bits (Q8).
+//
+//*****************************************************************************
+uint32_t getFilteredADCQ8(void) {
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_MEDIAN
+    return getSlidingMedian(&g_medianFilter) << 8;
+#else
+    return getCircBufMeanQ8(&g_inBuffer);
+#endif
+}
+
+
+//*****************************************************************************
+//
+// Collects new samples from the ADC ISR, computes the filtered ADC value, and
+// passes the altitude to the controller. While on the ground the landed
+// reference slowly follows the mean to remove sensor drift. Called from the
+// main loop, or from the control interrupt in the timer mode, which is then
+// the single consumer of the sample ring.
+//
+//*****************************************************************************
+void updateAltitude(void) {
+    uint32_t newSamples;
+    int32_t drift;
+
+    // No critical section is needed for the sample ring
+    newSamples = drainADCSamples();
+    g_meanADCValQ8 = getFilteredADCQ8();
+    g_meanADCVal = (g_meanADCValQ8 + Q8_HALF) >> Q8_SHIFT;
+
+    if (newSamples && getModeState() == LANDED) {
+        // The reference is kept in Q16 so the shifted step does not lose the
+        // last few counts, and the step is rounded to nearest either way, as
+        // a plain shift would round negative steps away from zero and leave
+        // the reference below the mean
+        drift = (int32_t)((g_meanADCValQ8 << (Q16_SHIFT - Q8_SHIFT)) - g_landedADCValQ16);
+        if (drift >= 0) {
+            g_landedADCValQ16 += (drift + LANDED_DRIFT_HALF) >> LANDED_DRIFT_SHIFT;
+        } else {
+            g_landedADCValQ16 -= (-drift + LANDED_DRIFT_HALF) >> LANDED_DRIFT_SHIFT;
+        }
+        if (((g_landedADCValQ16 + Q16_ONE / 2) >> Q16_SHIFT) != g_landedADCVal) {
+            g_landedADCVal = (g_landedADCValQ16 + Q16_ONE / 2) >> Q16_SHIFT;
+#if ALTITUDE_ESTIMATOR == ALTITUDE_ESTIMATOR_KALMAN
+            setKalmanLandedADC(g_landedADCVal);
+#endif
+        }
+    }
+
+    // The controller gets the altitude with 16 fractional bits, the display
+    // and UART use the rounded mean
+#if ALTITUDE_ESTIMATOR == ALTITUDE_ESTIMATOR_KALMAN
+    setCurrentHeight(getKalmanHeight());
+    setCurrentHeightVelocity(getKalmanVelocity());
+#else
+    setCurrentHeight(calcAltitudeQ16(g_landedADCVal, g_meanADCValQ8));
+#endif
+}
+
+
+//*****************************************************************************
+//
+// Runs one control step on a snapshot of the yaw, and adds the period since
+// the last step, from the passed timestamp of its start, to the statistics. Every PERIOD_STATS_BLOCK steps the
+// statistics are kept for the main loop to send, and restarted.
+//
+//*****************************************************************************
+void runControlStep(uint32_t start) {
+    updatePeriodStats(&g_controlPeriod, start);
+    if (getPeriodStatsCount(&g_controlPeriod) >= PERIOD_STATS_BLOCK) {
+        g_controlPeriodReport = g_controlPeriod;
+        resetPeriodStats(&g_controlPeriod);
+        periodFlag = FLAG_SET;
+    }
+
+    setCurrentYaw(getYawAngle());
+    setCurrentYawRate(getYawRate());
+    updateControl();
+}
+
+
+#if CONTROL_LOOP == CONTROL_LOOP_TIMER
+//*****************************************************************************
+//
+// The interrupt handler for the control loop, on TIMER4A at CONTROL_RATE_HZ.
+// Takes the altitude from the latest samples, then runs the control step.
+//
+//*****************************************************************************
+void controlIntHandler(void) {
+    uint32_t start = TIMESTAMP_NOW();
+
+    TimerIntClear(TIMER4_BASE, TIMER_TIMA_TIMEOUT);
+
+#if YAW_CONTROL == YAW_CONTROL_SINGLE
+    updateYawRate();
+#endif
+    updateAltitude();
+    runControlStep(start);
+}
+
+
+//*****************************************************************************
+//
+// Initialisation for the control loop timer, TIMER4A, at CONTROL_RATE_HZ.
+// Started once the landed altitude is known.
+//
+//*****************************************************************************
+void initControlTimer(void) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER4);
+    TimerConfigure(TIMER4_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER4_BASE, TIMER_A, SysCtlClockGet() / CONTROL_RATE_HZ - 1);
+    TimerIntRegister(TIMER4_BASE, TIMER_A, controlIntHandler);
+    TimerIntEnable(TIMER4_BASE, TIMER_TIMA_TIMEOUT);
+    TimerEnable(TIMER4_BASE, TIMER_A);
+}
+#endif
+
+
+//*****************************************************************************
+//
+// Sets the interrupt priorities. Both ADC sequences are set, as the sampler
+// mode chooses which one interrupts.
+//
+//*****************************************************************************
+void initInterruptPriorities(void) {
+    IntPrioritySet(INT_GPIOB, PRIORITY_QUADRATURE);
+    IntPrioritySet(INT_TIMER3A, PRIORITY_YAW_RATE_LOOP);
+    IntPrioritySet(INT_GPIOC, PRIORITY_YAW_REFERENCE);
+    IntPrioritySet(INT_TIMER4A, PRIORITY_CONTROL);
+    IntPrioritySet(INT_GPIOA, PRIORITY_CONTROL);
+    IntPrioritySet(INT_ADC0SS0, PRIORITY_BACKGROUND);
+    IntPrioritySet(INT_ADC0SS3, PRIORITY_BACKGROUND);
+    IntPrioritySet(FAULT_SYSTICK, PRIORITY_BACKGROUND);
 }
 
 
 int main(void) {
-    uint16_t landedADCVal;
-    uint16_t meanADCVal;
     uint8_t currentDisplayState = PERCENT;
 
     // Initialise peripherals and variables
 	initClock();
-	initADC();
+	initSpscBuf(&g_adcRing, g_adcRingStorage, ADC_RING_SIZE);
+	initADCSampler(&g_adcRing);
+#if ALTITUDE_FILTER != ALTITUDE_FILTER_MEAN
+	initSlidingMedian(&g_medianFilter);
+#endif
 	initButtons();
 	OLEDInitialise();
-	initCircBuf(&g_inBuffer, BUF_SIZE);
-	quadratureInitialise();
+	initTimestamp();
+	initYaw();
 	initialisePWM();
+	initControl();
 	initialiseUSB_UART();
 	initYawReferenceSignal();
 	initSliderSwitch();
+	initInterruptPriorities();
 
     // Initialisation is complete, so turn on the output.
     PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, true);
@@ -376,40 +539,59 @@ int main(void) {
     // Enable interrupts to the processor.
     IntMasterEnable();
 
-    // Wait to ensure buffer fills
-    SysCtlDelay(SysCtlClockGet() / BUFFER_FILL_DELAY);
-
-    // Compute the mean ADC value, set the zero altitude value
-    meanADCVal = calcMeanOfContents(&g_inBuffer, BUF_SIZE);
-    landedADCVal = meanADCVal;
+    // Collect landed samples until the noise statistics show the mean has
+    // settled, then use it as the zero altitude value
+    do {
+        drainADCSamples();
+    } while (!isLandedCalibrated());
+    g_landedADCValQ16 = getADCStatsMean(&g_adcStats);
+    g_landedADCVal = (g_landedADCValQ16 + Q16_ONE / 2) >> Q16_SHIFT;
+    resetADCStats(&g_adcStats);
+
+    // Seed the averaging buffer with the landed value so the mean is valid
+    // before the buffer has filled
+    fillCircBuf(&g_inBuffer, g_landedADCVal);
+    g_meanADCValQ8 = getFilteredADCQ8();
+    g_meanADCVal = (g_meanADCValQ8 + Q8_HALF) >> Q8_SHIFT;
+#if ALTITUDE_ESTIMATOR == ALTITUDE_ESTIMATOR_KALMAN
+    initAltitudeKalman(g_landedADCVal);
+#endif
 
     // Update the display
-    updateDisplay(currentDisplayState, landedADCVal, meanADCVal, yawSlotCount);
+    updateDisplay(currentDisplayState, g_landedADCVal, g_meanADCVal, getYawAngle());
 
     // The helicopter starts in the LANDED mode
     setMode(LANDED);
 
+    // From here the control interrupt takes the samples in the timer mode
+#if CONTROL_LOOP == CONTROL_LOOP_TIMER
+    initControlTimer();
+#endif
+
 	while (1)
 	{
-	    // Compute the mean ADC value.
-	    // Disable interrupts for this part to avoid a race condition.
-	    IntMasterDisable();
-	    meanADCVal = calcMeanOfContents(&g_inBuffer, BUF_SIZE);
-	    IntMasterEnable();
-
-	    setCurrentHeight(calcPercentAltitude(landedADCVal, meanADCVal));
-	    setCurrentYaw(yawSlotCount);
+#if CONTROL_LOOP == CONTROL_LOOP_MAIN
+	    updateAltitude();
+#endif
 
 	    // Update the display at 4Hz. displayFlag is set every 25 SysTick interrupts (250ms).
 	    if (displayFlag) {
 	        displayFlag = FLAG_CLEAR;
-	        updateDisplay(currentDisplayState, landedADCVal, meanADCVal, yawSlotCount);
+	        updateDisplay(currentDisplayState, g_landedADCVal, g_meanADCVal, getYawAngle());
 	    }
 
 	    // Send UART Data at 4Hz. UARTFlag is set every 25 SysTick interrupts (250ms).
 	    if (UARTFlag) {
 	        UARTFlag = FLAG_CLEAR;
-	        UARTSendData(landedADCVal, meanADCVal, yawSlotCount);
+	        UARTSendData(g_landedADCVal, g_meanADCVal, getYawAngle(), g_noiseVariance);
+	    }
+
+	    // Send the control period statistics every PERIOD_STATS_BLOCK steps.
+	    // The next block is not kept for another 5s, so no critical section
+	    // is needed.
+	    if (periodFlag) {
+	        periodFlag = FLAG_CLEAR;
+	        UARTSendPeriodStats("Control", &g_controlPeriodReport);
 	    }
 
 	    // Poll the buttons at 100Hz. Update their states if necessary.
@@ -419,11 +601,15 @@ int main(void) {
 	        checkButtons();
 	    }
 
+	    // Save the feedforward table and send tuning results for the controller
+	    serviceControl();
+
+#if CONTROL_LOOP == CONTROL_LOOP_MAIN
 	    // Update the PID controller. controlUpdateFlag is set every SysTick interrupt (10ms).
 	    if (controlUpdateFlag) {
 	        controlUpdateFlag = FLAG_CLEAR;
-	        updateControl();
+	        runControlStep(getTimestamp());
 	    }
+#endif
 	}
 }
-
@@ -0,0 +1,140 @@
+// *******************************************************
+//
+// pid.c
+//
+// Q16 fixed-point PID controller with a filtered derivative on
+// the measurement and conditional-integration anti-windup.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "pid.h"
+
+
+//*****************************************************************************
+//
+// Initialises a PID controller and resets its state.
+//
+//*****************************************************************************
+void initPID(pidController_t *pid, q16_t kp, q16_t ki, q16_t kd, q16_t dt,
+             q16_t derivativeTau, q16_t outputMin, q16_t outputMax) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->dt = dt;
+    pid->derivativeAlpha = (q16_t)(((int64_t) dt << Q16_SHIFT) / (derivativeTau + dt));
+    pid->outputMin = outputMin;
+    pid->outputMax = outputMax;
+    pid->feedforward = 0;
+    pid->integralHeld = false;
+    resetPID(pid);
+}
+
+
+//*****************************************************************************
+//
+// Clears the integrator and the derivative filter.
+//
+//*****************************************************************************
+void resetPID(pidController_t *pid) {
+    pid->integral = 0;
+    pid->derivative = 0;
+    pid->error = 0;
+}
+
+
+//*****************************************************************************
+//
+// Changes the gains. The integrator already holds Ki times the integral, so
+// Ki needs no correction. The change in the proportional term at the last
+// error is taken up by the integrator, and the derivative term moves to the
+// new Kd through its filter.
+//
+//*****************************************************************************
+void setPIDGains(pidController_t *pid, const pidGains_t *gains) {
+    pid->integral = q16Add(pid->integral, q16Mul(q16Add(pid->kp, -gains->kp), pid->error));
+    pid->kp = gains->kp;
+    pid->ki = gains->ki;
+    pid->kd = gains->kd;
+}
+
+
+//*****************************************************************************
+//
+// Sets the feedforward term added to the output.
+//
+//*****************************************************************************
+void setPIDFeedforward(pidController_t *pid, q16_t feedforward) {
+    pid->feedforward = feedforward;
+}
+
+
+//*****************************************************************************
+//
+// Holds or releases the integrator.
+//
+//*****************************************************************************
+void holdPIDIntegral(pidController_t *pid, bool hold) {
+    pid->integralHeld = hold;
+}
+
+
+//*****************************************************************************
+//
+// Gets the integrator, in output units.
+//
+//*****************************************************************************
+q16_t getPIDIntegral(pidController_t *pid) {
+    return pid->integral;
+}
+
+
+//*****************************************************************************
+//
+// Adds the passed amount to the integrator.
+//
+//*****************************************************************************
+void adjustPIDIntegral(pidController_t *pid, q16_t amount) {
+    pid->integral = q16Add(pid->integral, amount);
+}
+
+
+//*****************************************************************************
+//
+// Runs one update from the error and the rate of change of the measurement,
+// and returns the clamped output.
+//
+//*****************************************************************************
+q16_t updatePID(pidController_t *pid, q16_t error, q16_t measurementRate) {
+    q16_t proportional = q16Mul(pid->kp, error);
+    q16_t integral = q16Add(pid->integral, q16Mul(q16Mul(pid->ki, error), pid->dt));
+    q16_t output;
+
+    pid->error = error;
+
+    // Derivative on measurement, low-pass filtered
+    pid->derivative = q16Add(pid->derivative,
+                             q16Mul(pid->derivativeAlpha,
+                                    q16Add(-q16Mul(pid->kd, measurementRate), -pid->derivative)));
+
+    // Only integrate if the integrator is not held and the output is not
+    // saturated in the direction the error is pushing it
+    output = q16Add(q16Add(q16Add(proportional, integral), pid->derivative), pid->feedforward);
+    if (pid->integralHeld
+        || (output > pid->outputMax && error > 0) || (output < pid->outputMin && error < 0)) {
+        output = q16Add(q16Add(q16Add(proportional, pid->integral), pid->derivative), pid->feedforward);
+    } else {
+        pid->integral = integral;
+    }
+
+    if (output > pid->outputMax) {
+        output = pid->outputMax;
+    } else if (output < pid->outputMin) {
+        output = pid->outputMin;
+    }
+    return output;
+}
@@ -0,0 +1,133 @@
+#ifndef PID_H_
+#define PID_H_
+
+// *******************************************************
+//
+// pid.c
+//
+// Q16 fixed-point PID controller, one pidController_t per loop.
+// (Named pidController_t as pid_t is the POSIX process id type.)
+//
+// The derivative is taken on the measurement rate rather than
+// on the error, so reference steps do not kick the output, and
+// is passed through a first-order low-pass filter with time
+// constant derivativeTau. The integrator holds Ki times the
+// integral, in output units, so changing Ki does not step the
+// output. Changing Kp through setPIDGains() moves the step in
+// the proportional term into the integrator, so gains can be
+// changed while running without a bump in the output.
+// Anti-windup is by conditional integration: the
+// integrator is frozen while the output is saturated and the
+// error would drive it further into saturation. It can also be
+// held by the caller, e.g. while a reference profile moves and
+// the feedforward does the work. A feedforward term can be
+// added to the output, inside the clamps.
+//
+// An update is about 10 saturating Q16 operations. The host
+// tests (test/testPid.c) cover the anti-windup and the hold,
+// the derivative on measurement and its filter, and the clamps,
+// and test/benchPid.c times an update on the host (about 55
+// cycles, 26 ns, on an x86 PC). On the Cortex-M4 it is
+// estimated at about 150 cycles, which has not been measured
+// on the target.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+
+typedef struct {
+    q16_t kp;                   // Proportional gain
+    q16_t ki;                   // Integral gain, per second
+    q16_t kd;                   // Derivative gain, seconds
+    q16_t dt;                   // Update period, seconds
+    q16_t derivativeAlpha;      // Derivative filter coefficient, dt / (tau + dt)
+    q16_t outputMin;            // Output clamps
+    q16_t outputMax;
+    q16_t integral;             // Ki * integral of the error, output units
+    q16_t derivative;           // Filtered derivative term, output units
+    q16_t feedforward;          // Added to the output, output units
+    q16_t error;                // Error at the last update
+    bool integralHeld;          // Set to stop the integrator
+} pidController_t;
+
+// A set of gains, for gain scheduling
+typedef struct {
+    q16_t kp;
+    q16_t ki;
+    q16_t kd;
+} pidGains_t;
+
+
+//*****************************************************************************
+//
+// Initialises a PID controller with its gains, update period (dt), derivative
+// filter time constant (derivativeTau, 0 for no filter) and output clamps,
+// all Q16, and resets its state.
+//
+//*****************************************************************************
+void initPID(pidController_t *pid, q16_t kp, q16_t ki, q16_t kd, q16_t dt,
+             q16_t derivativeTau, q16_t outputMin, q16_t outputMax);
+
+
+//*****************************************************************************
+//
+// Clears the integrator and the derivative filter.
+//
+//*****************************************************************************
+void resetPID(pidController_t *pid);
+
+
+//*****************************************************************************
+//
+// Changes the gains without a step in the output.
+//
+//*****************************************************************************
+void setPIDGains(pidController_t *pid, const pidGains_t *gains);
+
+
+//*****************************************************************************
+//
+// Sets the feedforward term added to the output from the next update.
+//
+//*****************************************************************************
+void setPIDFeedforward(pidController_t *pid, q16_t feedforward);
+
+
+//*****************************************************************************
+//
+// Holds the integrator at its value from the next update while hold is set.
+//
+//*****************************************************************************
+void holdPIDIntegral(pidController_t *pid, bool hold);
+
+
+//*****************************************************************************
+//
+// Gets the integrator, in output units.
+//
+//*****************************************************************************
+q16_t getPIDIntegral(pidController_t *pid);
+
+
+//*****************************************************************************
+//
+// Adds the passed amount to the integrator, in output units. Used to move
+// part of the integrator into the feedforward without stepping the output.
+//
+//*****************************************************************************
+void adjustPIDIntegral(pidController_t *pid, q16_t amount);
+
+
+//*****************************************************************************
+//
+// Runs one update from the error (reference - measurement) and the rate of
+// change of the measurement, and returns the clamped output.
+//
+//*****************************************************************************
+q16_t updatePID(pidController_t *pid, q16_t error, q16_t measurementRate);
+
+#endif /*PID_H_*/
@@ -0,0 +1,42 @@
+#ifndef PRIORITIES_H_
+#define PRIORITIES_H_
+
+// *******************************************************
+//
+// priorities.h
+//
+// NVIC interrupt priorities (set in main.c). Only the top
+// three bits are used, and lower is more urgent.
+//
+// Quadrature edges preempt everything so none are lost, then
+// the inner yaw rate loop. The control step shares a level with
+// the slider switch, which changes the mode, and preempts the
+// ADC and SysTick, which only hand over samples and set flags.
+// The reference signal shares a level with whichever interrupt
+// calls updateYawRate(), as both move the yaw crossing.
+//
+// Data shared with an interrupt is protected by raising the
+// priority mask (BASEPRI) to that interrupt's level with
+// IntPriorityMaskSet() and restoring it afterwards, not by
+// IntMasterDisable(), so more urgent interrupts (above all the
+// quadrature edges) still run.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include "control.h"
+
+#define PRIORITY_QUADRATURE 0x00
+#define PRIORITY_YAW_RATE_LOOP 0x20
+#define PRIORITY_CONTROL 0x40
+#define PRIORITY_BACKGROUND 0x60
+#if YAW_CONTROL == YAW_CONTROL_CASCADE
+#define PRIORITY_YAW_REFERENCE PRIORITY_YAW_RATE_LOOP
+#elif CONTROL_LOOP == CONTROL_LOOP_TIMER
+#define PRIORITY_YAW_REFERENCE PRIORITY_CONTROL
+#else
+#define PRIORITY_YAW_REFERENCE PRIORITY_BACKGROUND
+#endif
+
+#endif /*PRIORITIES_H_*/
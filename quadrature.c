@@ -0,0 +1,78 @@
+// *******************************************************
+//
+// quadrature.c
+//
+// Table decoding of the yaw encoder quadrature transitions
+// (see quadrature.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "quadrature.h"
+
+// Slot count change for each transition, indexed by
+// (previousYawState << 2) | currentYawState. Clockwise rotation steps through
+// the states 0 -> 2 -> 3 -> 1 -> 0. A transition between diagonally opposite
+// states means both channels changed, i.e. an edge was missed, and the
+// direction cannot be known.
+const int8_t quadratureTable[16] = {
+    0,                  // 0 -> 0
+    -YAW_DECREMENT,     // 0 -> 1
+    YAW_INCREMENT,      // 0 -> 2
+    QUADRATURE_ERROR,   // 0 -> 3
+    YAW_INCREMENT,      // 1 -> 0
+    0,                  // 1 -> 1
+    QUADRATURE_ERROR,   // 1 -> 2
+    -YAW_DECREMENT,     // 1 -> 3
+    -YAW_DECREMENT,     // 2 -> 0
+    QUADRATURE_ERROR,   // 2 -> 1
+    0,                  // 2 -> 2
+    YAW_INCREMENT,      // 2 -> 3
+    QUADRATURE_ERROR,   // 3 -> 0
+    YAW_INCREMENT,      // 3 -> 1
+    -YAW_DECREMENT,     // 3 -> 2
+    0                   // 3 -> 3
+};
+
+static volatile uint32_t quadratureErrors;  // Number of illegal transitions seen
+
+
+//*****************************************************************************
+//
+// Determines the rotation direction of the disk and increments or decrements
+// the slot count appropriately, using a table lookup on the previous and
+// current states. Illegal transitions leave the count unchanged and are
+// counted instead.
+//
+//*****************************************************************************
+void quadratureDecode(int* yawSlotCount, int currentYawState, int previousYawState) {
+    int8_t step = quadratureTable[((previousYawState & 0x03) << 2) | (currentYawState & 0x03)];
+
+    if (step == QUADRATURE_ERROR) {
+        quadratureErrors++;
+    } else {
+        *yawSlotCount = *yawSlotCount + step;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Counts an illegal transition.
+//
+//*****************************************************************************
+void countQuadratureError(void) {
+    quadratureErrors++;
+}
+
+
+//*****************************************************************************
+//
+// Returns the number of illegal quadrature transitions seen since reset.
+//
+//*****************************************************************************
+uint32_t getQuadratureErrors(void) {
+    return quadratureErrors;
+}
@@ -0,0 +1,63 @@
+#ifndef QUADRATURE_H_
+#define QUADRATURE_H_
+
+// *******************************************************
+//
+// quadrature.c
+//
+// Table decoding of the yaw encoder quadrature transitions,
+// with a count of illegal transitions. Used by the GPIO
+// backend of yaw.c, and built on the host for the tests in
+// test/.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+// Possible states of the yaw sensors
+// The yaw signals are on pins 0 and 1. GPIOPinRead returns a bit packed
+// byte where the zeroth bit is the state of pin 0, the first bit is the state 
+// of pin 1 on the port, etc. Bits two to seven are not read by the quadrature decoder,
+// and hence their bit in the returned byte is zero. So PB0 low and PB1 low returns 0x00
+// when read, PB0 high and PB1 low returns 0x01 when read etc.
+enum yawStates {B_LOW_A_LOW = 0, B_LOW_A_HIGH, B_HIGH_A_LOW, B_HIGH_A_HIGH};
+
+#define YAW_INCREMENT 1
+#define YAW_DECREMENT 1
+#define QUADRATURE_ERROR 2  // Decode table entry for an illegal transition
+
+// Slot count change for each transition, indexed by
+// (previousYawState << 2) | currentYawState. Read directly by the quadrature
+// ISR.
+extern const int8_t quadratureTable[16];
+
+
+//*****************************************************************************
+//
+// Determines the rotation direction of the disk and increments or decrements
+// the slot count appropriately. Illegal transitions (both channels changed)
+// leave the count unchanged and increment the quadrature error count.
+//
+//*****************************************************************************
+void quadratureDecode(int* yawSlotCount, int currentYawState, int previousYawState);
+
+
+//*****************************************************************************
+//
+// Counts an illegal transition found by a caller of quadratureTable.
+//
+//*****************************************************************************
+void countQuadratureError(void);
+
+
+//*****************************************************************************
+//
+// Returns the number of illegal quadrature transitions seen since reset.
+// Always zero with the QEI backend, which does not report them.
+//
+//*****************************************************************************
+uint32_t getQuadratureErrors(void);
+
+#endif /*QUADRATURE_H_*/
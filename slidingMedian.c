@@ -0,0 +1,195 @@
+// *******************************************************
+//
+// slidingMedian.c
+//
+// Running median over the last N samples in O(log N) per
+// sample, using a max-heap and a min-heap that share one array
+// with the median between them. See slidingMedian.h.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circBufT.h"
+#include "slidingMedian.h"
+
+// Number of entries in each heap for the current sample count
+#define MIN_COUNT(filter) (((filter)->count - 1) / 2)
+#define MAX_COUNT(filter) ((filter)->count / 2)
+
+
+//*****************************************************************************
+//
+// Returns true if the value at heap position i is less than the value at
+// heap position j.
+//
+//*****************************************************************************
+static bool heapLess(slidingMedian_t *filter, int16_t i, int16_t j) {
+    return filter->values[filter->heap[i]] < filter->values[filter->heap[j]];
+}
+
+
+//*****************************************************************************
+//
+// Swaps heap positions i and j if the value at i is less than the value at j.
+// Returns true if they were swapped.
+//
+//*****************************************************************************
+static bool heapSwapIfLess(slidingMedian_t *filter, int16_t i, int16_t j) {
+    int16_t slot;
+
+    if (!heapLess(filter, i, j)) {
+        return false;
+    }
+
+    slot = filter->heap[i];
+    filter->heap[i] = filter->heap[j];
+    filter->heap[j] = slot;
+    filter->pos[filter->heap[i]] = i;
+    filter->pos[filter->heap[j]] = j;
+    return true;
+}
+
+
+//*****************************************************************************
+//
+// Restores the min-heap from position i down, where i is the first child to
+// compare with its parent. Position 1 is the only child of the median.
+//
+//*****************************************************************************
+static void minSortDown(slidingMedian_t *filter, int16_t i) {
+    for (; i <= MIN_COUNT(filter); i *= 2) {
+        if (i > 1 && i < MIN_COUNT(filter) && heapLess(filter, i + 1, i)) {
+            i++;
+        }
+        if (!heapSwapIfLess(filter, i, i / 2)) {
+            break;
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Restores the max-heap (negative positions) from position i down, where i is
+// the first child to compare with its parent. Position -1 is the only child
+// of the median.
+//
+//*****************************************************************************
+static void maxSortDown(slidingMedian_t *filter, int16_t i) {
+    for (; i >= -MAX_COUNT(filter); i *= 2) {
+        if (i < -1 && i > -MAX_COUNT(filter) && heapLess(filter, i, i - 1)) {
+            i--;
+        }
+        if (!heapSwapIfLess(filter, i / 2, i)) {
+            break;
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Moves the entry at min-heap position i up towards the median.
+// Returns true if it became the median.
+//
+//*****************************************************************************
+static bool minSortUp(slidingMedian_t *filter, int16_t i) {
+    while (i > 0 && heapSwapIfLess(filter, i, i / 2)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+
+//*****************************************************************************
+//
+// Moves the entry at max-heap position i up towards the median.
+// Returns true if it became the median.
+//
+//*****************************************************************************
+static bool maxSortUp(slidingMedian_t *filter, int16_t i) {
+    while (i < 0 && heapSwapIfLess(filter, i / 2, i)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+
+//*****************************************************************************
+//
+// Empties the window and sets up the initial heap layout.
+//
+//*****************************************************************************
+void initSlidingMedian(slidingMedian_t *filter) {
+    int16_t slot;
+
+    filter->count = 0;
+    filter->oldest = 0;
+
+    // Slots are placed median, max, min, max, min... so that the heaps
+    // grow alternately as the window fills
+    for (slot = 0; slot < filter->size; slot++) {
+        filter->pos[slot] = ((slot + 1) / 2) * ((slot & 1) ? -1 : 1);
+        filter->heap[filter->pos[slot]] = slot;
+        filter->values[slot] = 0;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Adds a sample to the window, replacing the oldest one once the window is
+// full.
+//
+//*****************************************************************************
+void insertSlidingMedian(slidingMedian_t *filter, uint32_t sample) {
+    bool isNew = filter->count < filter->size;
+    int16_t p = filter->pos[filter->oldest];
+    circBufEntry_t value = (circBufEntry_t) sample;
+    circBufEntry_t old = filter->values[filter->oldest];
+
+    filter->values[filter->oldest] = value;
+    filter->oldest++;
+    if (filter->oldest >= filter->size) {
+        filter->oldest = 0;
+    }
+    if (isNew) {
+        filter->count++;
+    }
+
+    // Sift the replaced entry in whichever direction its new value needs
+    if (p > 0) {
+        if (!isNew && old < value) {
+            minSortDown(filter, p * 2);
+        } else if (minSortUp(filter, p)) {
+            maxSortDown(filter, -1);
+        }
+    } else if (p < 0) {
+        if (!isNew && value < old) {
+            maxSortDown(filter, p * 2);
+        } else if (maxSortUp(filter, p)) {
+            minSortDown(filter, 1);
+        }
+    } else {
+        if (MAX_COUNT(filter)) {
+            maxSortDown(filter, -1);
+        }
+        if (MIN_COUNT(filter)) {
+            minSortDown(filter, 1);
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Returns the median of the samples in the window. For an even number of
+// samples one of the two middle values is returned.
+//
+//*****************************************************************************
+uint32_t getSlidingMedian(slidingMedian_t *filter) {
+    return filter->values[filter->heap[0]];
+}
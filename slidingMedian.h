@@ -0,0 +1,78 @@
+#ifndef SLIDINGMEDIAN_H_
+#define SLIDINGMEDIAN_H_
+
+// *******************************************************
+//
+// slidingMedian.c
+//
+// Running median over the last N samples in O(log N) per
+// sample. The window is kept as a max-heap of the values below
+// the median and a min-heap of the values above it, sharing one
+// array with the median in the middle:
+//   heap[-maxCount .. -1]   max-heap (smaller values)
+//   heap[0]                 median
+//   heap[1 .. minCount]     min-heap (larger values)
+// The heaps hold slot numbers in the circular array of values,
+// and pos[] maps each slot back to its heap position, so the
+// oldest sample can be replaced in place and sifted up or down
+// instead of re-sorting the window.
+//
+// test/benchSlidingMedian.c measures an insert and query at
+// 30-35, 38-47 and 57-64 ns for windows of 15, 40 and 128 on the
+// x86 host, against 3-10 ns for the running mean of circBufT.c.
+// Those are relative costs; the Cortex-M4 is not measured.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "circBufT.h"
+
+typedef struct {
+    int16_t size;               // Window length N
+    int16_t count;              // Number of samples in the window (<= size)
+    int16_t oldest;             // Slot the next sample replaces
+    circBufEntry_t *values;     // Circular array of samples, by slot
+    int16_t *pos;               // Heap position of each slot
+    int16_t *heap;              // Points to the middle (median) of the heap storage
+} slidingMedian_t;
+
+// *******************************************************
+// SLIDING_MEDIAN_STATIC: Define a median filter called name with a
+// window of windowSize samples and statically allocated storage. It
+// must be passed to initSlidingMedian() before use.
+#define SLIDING_MEDIAN_STATIC(name, windowSize) \
+    static circBufEntry_t name##Values[(windowSize)]; \
+    static int16_t name##Pos[(windowSize)]; \
+    static int16_t name##Heap[(windowSize)]; \
+    static slidingMedian_t name = {(windowSize), 0, 0, name##Values, name##Pos, \
+                                   name##Heap + (windowSize) / 2}
+
+
+//*****************************************************************************
+//
+// Empties the window and sets up the initial heap layout.
+//
+//*****************************************************************************
+void initSlidingMedian(slidingMedian_t *filter);
+
+
+//*****************************************************************************
+//
+// Adds a sample to the window, replacing the oldest one once the window is
+// full.
+//
+//*****************************************************************************
+void insertSlidingMedian(slidingMedian_t *filter, uint32_t sample);
+
+
+//*****************************************************************************
+//
+// Returns the median of the samples in the window. For an even number of
+// samples one of the two middle values is returned.
+//
+//*****************************************************************************
+uint32_t getSlidingMedian(slidingMedian_t *filter);
+
+#endif /*SLIDINGMEDIAN_H_*/
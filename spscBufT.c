@@ -0,0 +1,140 @@
+// *******************************************************
+//
+// spscBufT.c
+//
+// Lock-free single-producer/single-consumer ring buffer of
+// uint32_t values. One side (e.g. an ISR) only writes and the
+// other side (e.g. the main loop) only reads, so no critical
+// section is needed to share data between them.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spscBufT.h"
+
+// *******************************************************
+// initSpscBuf: Initialise the buffer to use the given storage of
+// size entries. Returns false if size is not a power of two.
+bool
+initSpscBuf(spscBuf_t *buffer, uint32_t *storage, uint32_t size)
+{
+    if (size == 0 || (size & (size - 1)) != 0)
+        return false;
+
+    buffer->size = size;
+    buffer->mask = size - 1;
+    buffer->windex = 0;
+    buffer->rindex = 0;
+    buffer->overruns = 0;
+    buffer->data = storage;
+    return true;
+}
+
+// *******************************************************
+// writeSpscBuf: Producer side. Stores entry and then publishes it by
+// advancing windex. If the buffer is full the entry is dropped, the
+// overrun count is incremented and false is returned.
+bool
+writeSpscBuf(spscBuf_t *buffer, uint32_t entry)
+{
+    uint32_t windex = buffer->windex;
+
+    // Acquire rindex so the slot is known to have been read
+    if (windex - buffer->rindex >= buffer->size) {
+        buffer->overruns++;
+        return false;
+    }
+    SPSC_MEMORY_BARRIER();
+
+    buffer->data[windex & buffer->mask] = entry;
+
+    // Release: the entry must be visible before the new windex
+    SPSC_MEMORY_BARRIER();
+    buffer->windex = windex + 1;
+    return true;
+}
+
+// *******************************************************
+// writeSpscBufBulk: Producer side. Stores up to count entries and
+// publishes them with a single windex update. Entries that do not
+// fit are dropped and counted as overruns. Returns the number of
+// entries written.
+uint32_t
+writeSpscBufBulk(spscBuf_t *buffer, const uint32_t *entries, uint32_t count)
+{
+    uint32_t windex = buffer->windex;
+    uint32_t space = buffer->size - (windex - buffer->rindex);
+    uint32_t i;
+
+    if (count > space) {
+        buffer->overruns += count - space;
+        count = space;
+    }
+    SPSC_MEMORY_BARRIER();
+
+    for (i = 0; i < count; i++)
+        buffer->data[(windex + i) & buffer->mask] = entries[i];
+
+    // Release: the entries must be visible before the new windex
+    SPSC_MEMORY_BARRIER();
+    buffer->windex = windex + count;
+    return count;
+}
+
+// *******************************************************
+// availableSpscBuf: Consumer side. Returns the number of entries
+// written but not yet consumed.
+uint32_t
+availableSpscBuf(spscBuf_t *buffer)
+{
+    return buffer->windex - buffer->rindex;
+}
+
+// *******************************************************
+// peekSpscBuf: Consumer side. Copies up to maxEntries of the unread
+// entries, oldest first, into dest without consuming them. Returns
+// the number of entries copied.
+uint32_t
+peekSpscBuf(spscBuf_t *buffer, uint32_t *dest, uint32_t maxEntries)
+{
+    uint32_t rindex = buffer->rindex;
+    uint32_t count = buffer->windex - rindex;
+    uint32_t i;
+
+    // Acquire: only read entries after windex has been seen to cover them
+    SPSC_MEMORY_BARRIER();
+
+    if (count > maxEntries)
+        count = maxEntries;
+
+    for (i = 0; i < count; i++)
+        dest[i] = buffer->data[(rindex + i) & buffer->mask];
+
+    return count;
+}
+
+// *******************************************************
+// consumeSpscBuf: Consumer side. Releases count entries back to the
+// producer. count must not exceed availableSpscBuf().
+void
+consumeSpscBuf(spscBuf_t *buffer, uint32_t count)
+{
+    // Release: finish reading the entries before handing the slots back
+    SPSC_MEMORY_BARRIER();
+    buffer->rindex = buffer->rindex + count;
+}
+
+// *******************************************************
+// readSpscBuf: Consumer side. Copies and consumes up to maxEntries
+// of the unread entries. Returns the number of entries read.
+uint32_t
+readSpscBuf(spscBuf_t *buffer, uint32_t *dest, uint32_t maxEntries)
+{
+    uint32_t count = peekSpscBuf(buffer, dest, maxEntries);
+
+    consumeSpscBuf(buffer, count);
+    return count;
+}
@@ -0,0 +1,96 @@
+#ifndef SPSCBUFT_H_
+#define SPSCBUFT_H_
+
+// *******************************************************
+//
+// spscBufT.h
+//
+// Lock-free single-producer/single-consumer ring buffer of
+// uint32_t values. One side (e.g. an ISR) only writes and the
+// other side (e.g. the main loop) only reads, so no critical
+// section is needed to share data between them.
+//
+// The capacity must be a power of two. Both indices run freely
+// and are masked when the data array is accessed, so the
+// number of unread entries is always (windex - rindex).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// *******************************************************
+// Memory barrier used to publish an index only after the data it
+// covers is visible (release), and to read data only after the index
+// that covers it (acquire). The Cortex-M4 is single core, so this
+// mostly stops the compiler reordering accesses around the index.
+// The host tests (test/) run the producer and consumer as threads on
+// different cores, and use a full fence.
+#if defined(__TI_COMPILER_VERSION__)
+#define SPSC_MEMORY_BARRIER() __asm(" dmb")
+#elif defined(__arm__)
+#define SPSC_MEMORY_BARRIER() __asm volatile ("dmb" : : : "memory")
+#else
+#define SPSC_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// *******************************************************
+// Buffer structure
+typedef struct {
+    uint32_t size;                  // Number of entries in buffer, a power of two
+    uint32_t mask;                  // size - 1, used to wrap the indices
+    volatile uint32_t windex;       // Free running write index, producer only
+    volatile uint32_t rindex;       // Free running read index, consumer only
+    volatile uint32_t overruns;     // Entries dropped because the buffer was full
+    uint32_t *data;                 // Pointer to the data
+} spscBuf_t;
+
+// *******************************************************
+// initSpscBuf: Initialise the buffer to use the given storage of
+// size entries. Returns false if size is not a power of two.
+bool
+initSpscBuf(spscBuf_t *buffer, uint32_t *storage, uint32_t size);
+
+// *******************************************************
+// writeSpscBuf: Producer side. Stores entry and then publishes it by
+// advancing windex. If the buffer is full the entry is dropped, the
+// overrun count is incremented and false is returned.
+bool
+writeSpscBuf(spscBuf_t *buffer, uint32_t entry);
+
+// *******************************************************
+// writeSpscBufBulk: Producer side. Stores up to count entries and
+// publishes them with a single windex update. Entries that do not
+// fit are dropped and counted as overruns. Returns the number of
+// entries written.
+uint32_t
+writeSpscBufBulk(spscBuf_t *buffer, const uint32_t *entries, uint32_t count);
+
+// *******************************************************
+// availableSpscBuf: Consumer side. Returns the number of entries
+// written but not yet consumed.
+uint32_t
+availableSpscBuf(spscBuf_t *buffer);
+
+// *******************************************************
+// peekSpscBuf: Consumer side. Copies up to maxEntries of the unread
+// entries, oldest first, into dest without consuming them. Returns
+// the number of entries copied.
+uint32_t
+peekSpscBuf(spscBuf_t *buffer, uint32_t *dest, uint32_t maxEntries);
+
+// *******************************************************
+// consumeSpscBuf: Consumer side. Releases count entries back to the
+// producer. count must not exceed availableSpscBuf().
+void
+consumeSpscBuf(spscBuf_t *buffer, uint32_t count);
+
+// *******************************************************
+// readSpscBuf: Consumer side. Copies and consumes up to maxEntries
+// of the unread entries. Returns the number of entries read.
+uint32_t
+readSpscBuf(spscBuf_t *buffer, uint32_t *dest, uint32_t maxEntries);
+
+#endif /*SPSCBUFT_H_*/
@@ -0,0 +1,67 @@
+// *******************************************************
+//
+// benchAdcSampler.c
+//
+// Host benchmark of the acquisition work in adcSampler.c per
+// conversion, built once in ADC_MODE_UDMA and once in
+// ADC_MODE_TIMER against the simulated ADC and uDMA in
+// stubs/adcDmaStub.c. It times simConvert(), so it includes
+// the simulation of the hardware as well as the interrupt
+// handlers and the ring writes. The main loop's read of the
+// ring is timed too. Interrupt entry and exit are not
+// included. Host figures show relative costs only.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "spscBufT.h"
+#include "adcSampler.h"
+#include "simAdc.h"
+
+#define CONVERSIONS 50000000
+#define RING_SIZE 256
+
+#if ADC_SAMPLER_MODE == ADC_MODE_UDMA
+#define MODE_NAME "ADC_MODE_UDMA"
+#else
+#define MODE_NAME "ADC_MODE_TIMER"
+#endif
+
+
+int main(void) {
+    static uint32_t storage[RING_SIZE];
+    spscBuf_t ring;
+    uint32_t output[ADC_MEAN_WINDOW];
+    uint32_t total = 0;
+    uint32_t interrupts;
+    uint64_t startNanos;
+    uint64_t startCycles;
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t n;
+
+    initSpscBuf(&ring, storage, RING_SIZE);
+    initADCSampler(&ring);
+    interrupts = simAdcInterrupts();
+
+    startNanos = benchNanos();
+    startCycles = benchCycles();
+    for (n = 0; n < CONVERSIONS; n++) {
+        simConvert((uint16_t)(2000 + (n & 63)));
+        if ((n & (CIC_DECIMATION - 1)) == 0) {
+            total += readSpscBuf(&ring, output, ADC_MEAN_WINDOW);
+        }
+    }
+    cycles = benchCycles() - startCycles;
+    nanos = benchNanos() - startNanos;
+    BENCH_KEEP(total);
+
+    printf("%s: %.2f ns/conversion, %.2f host cycles/conversion, %.4f interrupts/conversion\n",
+           MODE_NAME, (double) nanos / CONVERSIONS, (double) cycles / CONVERSIONS,
+           (double)(simAdcInterrupts() - interrupts) / CONVERSIONS);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// *******************************************************
+//
+// benchAltitudeKalman.c
+//
+// Host benchmark of updateAltitudeKalman() in
+// altitudeKalman.c, in samples per second. The samples are a
+// noisy hover, and the duty moves about the hover duty, so the
+// filter takes both its predict and correct steps each sample.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "fixedPoint.h"
+#include "altitudeKalman.h"
+
+#define LANDED_ADC 2500
+#define SEQUENCE_SAMPLES 4096       // Power of 2
+#define SAMPLES 20000000
+
+
+int main(void) {
+    static uint16_t samples[SEQUENCE_SAMPLES];
+    static uint8_t duties[SEQUENCE_SAMPLES];
+    uint32_t random = 12345;
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t i;
+
+    // About 40% altitude with +/- 3 counts of noise, and 35-45% duty
+    for (i = 0; i < SEQUENCE_SAMPLES; i++) {
+        random = random * 1664525u + 1013904223u;
+        samples[i] = LANDED_ADC - 400 + (random >> 24) % 7 - 3;
+        duties[i] = 35 + (random >> 8) % 11;
+    }
+
+    initAltitudeKalman(LANDED_ADC);
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < SAMPLES; i++) {
+        updateAltitudeKalman(samples[i & (SEQUENCE_SAMPLES - 1)], duties[i & (SEQUENCE_SAMPLES - 1)]);
+    }
+    nanos = benchNanos() - nanos;
+    cycles = benchCycles() - cycles;
+    BENCH_KEEP(getKalmanHeight());
+
+    printf("updateAltitudeKalman, %d sample(s) per step: %.1f M samples/s, %.2f ns/sample, "
+           "%.2f host cycles/sample\n", KALMAN_SAMPLES_PER_STEP, SAMPLES * 1000.0 / nanos,
+           (double) nanos / SAMPLES, (double) cycles / SAMPLES);
+    return 0;
+}
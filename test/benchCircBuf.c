@@ -0,0 +1,102 @@
+// *******************************************************
+//
+// benchCircBuf.c
+//
+// Host benchmark of the mean of the 40-sample altitude
+// buffer, in ns per query. The running sum query,
+// getCircBufMean() and getCircBufMeanQ8(), is timed against
+// the walk the main loop used to make with interrupts
+// masked: calcMeanOfContents(), reading all 40 entries with
+// readCircBuf(), as removed from circBufT.c. The whole walk
+// was the masked interrupt time. The running sum is read in
+// the context that writes it, so nothing is masked for it.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "circBufT.h"
+
+#define BUF_SIZE 40                 // ADC_MEAN_WINDOW in the processor triggered modes
+#define QUERIES 20000000
+
+CIRCBUF_STATIC(buffer, BUF_SIZE);
+
+static uint32_t rindex;             // Read index of the removed readCircBuf()
+
+
+//*****************************************************************************
+//
+// The removed mean: reads every entry through readCircBuf().
+//
+//*****************************************************************************
+static uint32_t readEntry(circBuf_t *buffer) {
+    uint32_t entry = buffer->data[rindex];
+
+    rindex++;
+    if (rindex >= buffer->size) {
+        rindex = 0;
+    }
+    return entry;
+}
+
+static int32_t calcMeanOfContents(circBuf_t *buffer, uint16_t bufferSize) {
+    int32_t sum = 0;
+    uint16_t i;
+
+    for (i = 0; i < bufferSize; i++) {
+        sum = sum + readEntry(buffer);
+    }
+    return (2 * sum + bufferSize) / 2 / bufferSize;
+}
+
+
+//*****************************************************************************
+//
+// Prints the cost of a timed run.
+//
+//*****************************************************************************
+static void report(const char *name, uint64_t nanos, uint64_t cycles, int masked) {
+    printf("%s: %.2f ns/query, %.2f host cycles/query, interrupts masked %.2f ns/query\n", name,
+           (double) nanos / QUERIES, (double) cycles / QUERIES, masked ? (double) nanos / QUERIES : 0.0);
+}
+
+
+int main(void) {
+    uint32_t random = 12345;
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t mean = 0;
+    uint32_t i;
+
+    for (i = 0; i < BUF_SIZE; i++) {
+        random = random * 1664525u + 1013904223u;
+        writeCircBuf(&buffer, 1984 + (random >> 27));
+    }
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < QUERIES; i++) {
+        mean += calcMeanOfContents(&buffer, BUF_SIZE);
+    }
+    report("Walk (removed)  ", benchNanos() - nanos, benchCycles() - cycles, 1);
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < QUERIES; i++) {
+        mean += getCircBufMean(&buffer);
+    }
+    report("getCircBufMean  ", benchNanos() - nanos, benchCycles() - cycles, 0);
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < QUERIES; i++) {
+        mean += getCircBufMeanQ8(&buffer);
+    }
+    report("getCircBufMeanQ8", benchNanos() - nanos, benchCycles() - cycles, 0);
+    BENCH_KEEP(mean);
+    return 0;
+}
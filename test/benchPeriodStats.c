@@ -0,0 +1,78 @@
+// *******************************************************
+//
+// benchPeriodStats.c
+//
+// Host benchmark of the control period statistics
+// (updatePeriodStats() in timestamp.c), which runControlStep()
+// calls on every control step, in ns per update. The
+// timestamps are 10 ms control periods at 20 MHz with up to
+// +/- 50 us of jitter. As in runControlStep(), the statistics
+// are restarted every PERIOD_STATS_BLOCK updates. The cost of
+// reading the statistics (getPeriodStatsStdDev(), once every
+// 5 s in main.c) is timed as well.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "timestamp.h"
+
+#define SEQUENCE_UPDATES 4096       // Power of 2
+#define UPDATES 20000000
+#define READS 2000000
+#define CONTROL_PERIOD 200000       // Cycles, 10 ms at 20 MHz
+#define JITTER 1000                 // Cycles either side, 50 us
+#define PERIOD_STATS_BLOCK 500      // As in main.c
+
+
+int main(void) {
+    static uint32_t timestamps[SEQUENCE_UPDATES];
+    periodStats_t stats = {0};
+    periodStats_t report = {0};
+    uint32_t random = 12345;
+    uint32_t timestamp = 0;
+    uint32_t deviation = 0;
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t i;
+
+    for (i = 0; i < SEQUENCE_UPDATES; i++) {
+        random = random * 1664525u + 1013904223u;
+        timestamps[i] = CONTROL_PERIOD - JITTER + (random >> 16) % (2 * JITTER + 1);
+    }
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < UPDATES; i++) {
+        timestamp += timestamps[i & (SEQUENCE_UPDATES - 1)];
+        updatePeriodStats(&stats, timestamp);
+        if (getPeriodStatsCount(&stats) >= PERIOD_STATS_BLOCK) {
+            report = stats;
+            resetPeriodStats(&stats);
+        }
+    }
+    nanos = benchNanos() - nanos;
+    cycles = benchCycles() - cycles;
+    printf("updatePeriodStats: %.2f ns/update, %.2f host cycles/update\n",
+           (double) nanos / UPDATES, (double) cycles / UPDATES);
+    printf("  %u periods: mean %u, min %u, max %u, SD %u cycles\n",
+           (unsigned int) getPeriodStatsCount(&report), (unsigned int) getPeriodStatsMean(&report),
+           (unsigned int) getPeriodStatsMin(&report), (unsigned int) getPeriodStatsMax(&report),
+           (unsigned int) getPeriodStatsStdDev(&report));
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < READS; i++) {
+        report.m2 += i;
+        deviation += getPeriodStatsStdDev(&report);
+    }
+    nanos = benchNanos() - nanos;
+    cycles = benchCycles() - cycles;
+    BENCH_KEEP(deviation);
+    printf("getPeriodStatsStdDev: %.2f ns/read, %.2f host cycles/read\n",
+           (double) nanos / READS, (double) cycles / READS);
+    return 0;
+}
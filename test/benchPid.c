@@ -0,0 +1,52 @@
+// *******************************************************
+//
+// benchPid.c
+//
+// Host benchmark of one updatePID() call (pid.c), with the
+// gains and filter used by the altitude controller. Reports
+// nanoseconds and host cycles per update.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "fixedPoint.h"
+#include "pid.h"
+
+#define UPDATES 10000000
+
+
+int main(void) {
+    pidController_t pid;
+    q16_t errors[256];
+    q16_t output = 0;
+    uint64_t startNanos;
+    uint64_t startCycles;
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t i;
+
+    // Errors that keep the controller moving in and out of saturation
+    for (i = 0; i < 256; i++) {
+        errors[i] = (q16_t)((int32_t)(i * 2654435761u) >> 8);
+    }
+
+    initPID(&pid, Q16(1.0), Q16(0.47), Q16(0.25), Q16(0.01), Q16(0.02),
+            INT_TO_Q16(2), INT_TO_Q16(98));
+
+    startNanos = benchNanos();
+    startCycles = benchCycles();
+    for (i = 0; i < UPDATES; i++) {
+        output += updatePID(&pid, errors[i & 255], errors[(i + 77) & 255]);
+    }
+    cycles = benchCycles() - startCycles;
+    nanos = benchNanos() - startNanos;
+    BENCH_KEEP(output);
+
+    printf("updatePID: %.1f ns/update, %.1f host cycles/update\n",
+           (double) nanos / UPDATES, (double) cycles / UPDATES);
+    return 0;
+}
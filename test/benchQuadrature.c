@@ -0,0 +1,165 @@
+// *******************************************************
+//
+// benchQuadrature.c
+//
+// Host benchmark of the quadrature decoding, in edges per
+// second: the body of quadratureIntHandler() in yaw.c (the
+// inline table lookup and the angle update), a call to
+// quadratureDecode(), and the decoding the ISR used to do (the
+// nested if/else decoder of the original yaw.c, called out of
+// line, and the wrap of the slot count to one revolution). The
+// ratio of the old path to the ISR body is printed. The edges
+// are a generated sequence that changes direction at random,
+// so the branches on the step are not predictable. Interrupt
+// entry and exit, and the register accesses, are not included.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "quadrature.h"
+#include "yawAngle.h"
+
+#define SEQUENCE_EDGES 4096         // Power of 2
+#define EDGES 100000000
+#define TOTAL_SLOTS 448
+
+static const uint8_t clockwiseOrder[4] = {B_LOW_A_LOW, B_HIGH_A_LOW, B_HIGH_A_HIGH, B_LOW_A_HIGH};
+
+
+//*****************************************************************************
+//
+// The decoder the ISR used to call, as in the original yaw.c. It is kept out
+// of line, as it was in its own file.
+//
+//*****************************************************************************
+static __attribute__((noinline)) void oldQuadratureDecode(int *yawSlotCount, int currentYawState,
+                                                          int previousYawState) {
+    if (currentYawState == B_HIGH_A_LOW) {
+        if (previousYawState == B_LOW_A_LOW) {
+            *yawSlotCount = *yawSlotCount + 1;
+        } else {
+            *yawSlotCount = *yawSlotCount - 1;
+        }
+    } else if (currentYawState == B_HIGH_A_HIGH) {
+        if (previousYawState == B_HIGH_A_LOW) {
+            *yawSlotCount = *yawSlotCount + 1;
+        } else {
+            *yawSlotCount = *yawSlotCount - 1;
+        }
+    } else if (currentYawState == B_LOW_A_HIGH) {
+        if (previousYawState == B_HIGH_A_HIGH) {
+            *yawSlotCount = *yawSlotCount + 1;
+        } else {
+            *yawSlotCount = *yawSlotCount - 1;
+        }
+    } else {
+        if (previousYawState == B_LOW_A_HIGH) {
+            *yawSlotCount = *yawSlotCount + 1;
+        } else {
+            *yawSlotCount = *yawSlotCount - 1;
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Prints the rate of a timed run, and returns its time.
+//
+//*****************************************************************************
+static uint64_t report(const char *name, uint64_t nanos, uint64_t cycles) {
+    printf("%s: %.1f M edges/s, %.2f ns/edge, %.2f host cycles/edge\n", name,
+           EDGES * 1000.0 / nanos, (double) nanos / EDGES, (double) cycles / EDGES);
+    return nanos;
+}
+
+
+int main(void) {
+    static uint8_t states[SEQUENCE_EDGES];
+    uint32_t random = 12345;
+    uint32_t position = 0;
+    uint32_t previousState;
+    uint32_t state;
+    uint32_t lastEdge = 0;
+    bam_t angle = 0;
+    int32_t step;
+    int count = 0;
+    int slotCount = 0;
+    int yawSlotCount = 0;
+    uint64_t isrNanos;
+    uint64_t oldNanos;
+    uint64_t startNanos;
+    uint64_t startCycles;
+    uint32_t i;
+
+    // A random walk over the states, a quarter of the steps backwards
+    for (i = 0; i < SEQUENCE_EDGES; i++) {
+        random = random * 1664525u + 1013904223u;
+        position += ((random >> 24) < 64) ? 3 : 1;
+        states[i] = clockwiseOrder[position & 3];
+    }
+
+    // The ISR body
+    previousState = states[SEQUENCE_EDGES - 1];
+    startNanos = benchNanos();
+    startCycles = benchCycles();
+    for (i = 0; i < EDGES; i++) {
+        state = states[i & (SEQUENCE_EDGES - 1)];
+        step = quadratureTable[(previousState << 2) | state];
+        previousState = state;
+
+        if (step == QUADRATURE_ERROR) {
+            countQuadratureError();
+        } else if (step != 0) {
+            angle += step * BAM_PER_SLOT;
+            lastEdge = i;
+        }
+    }
+    isrNanos = report("ISR body", benchNanos() - startNanos, benchCycles() - startCycles);
+    BENCH_KEEP(angle);
+    BENCH_KEEP(lastEdge);
+
+    // quadratureDecode()
+    previousState = states[SEQUENCE_EDGES - 1];
+    startNanos = benchNanos();
+    startCycles = benchCycles();
+    for (i = 0; i < EDGES; i++) {
+        state = states[i & (SEQUENCE_EDGES - 1)];
+        quadratureDecode(&count, state, previousState);
+        previousState = state;
+    }
+    report("quadratureDecode", benchNanos() - startNanos, benchCycles() - startCycles);
+    BENCH_KEEP(count);
+
+    // The old ISR decoding
+    previousState = states[SEQUENCE_EDGES - 1];
+    startNanos = benchNanos();
+    startCycles = benchCycles();
+    for (i = 0; i < EDGES; i++) {
+        state = states[i & (SEQUENCE_EDGES - 1)];
+        slotCount = yawSlotCount;
+        oldQuadratureDecode(&slotCount, (int) state, (int) previousState);
+        previousState = state;
+
+        if (slotCount >= TOTAL_SLOTS) {
+            slotCount -= TOTAL_SLOTS;
+        } else if (slotCount < 0) {
+            slotCount += TOTAL_SLOTS;
+        }
+        if (slotCount != yawSlotCount) {
+            yawSlotCount = slotCount;
+            lastEdge = i;
+        }
+    }
+    oldNanos = report("Old decode and wrap", benchNanos() - startNanos, benchCycles() - startCycles);
+    BENCH_KEEP(yawSlotCount);
+    BENCH_KEEP(lastEdge);
+    printf("Old decode and wrap / ISR body: %.2f\n", (double) oldNanos / isrNanos);
+
+    printf("Illegal transitions: %u\n", (unsigned int) getQuadratureErrors());
+    return 0;
+}
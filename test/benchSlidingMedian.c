@@ -0,0 +1,109 @@
+// *******************************************************
+//
+// benchSlidingMedian.c
+//
+// Host benchmark of the altitude sample filters in main.c, in
+// ns per sample: the running median (insertSlidingMedian() and
+// getSlidingMedian()) over windows of 15, 40 and 128 samples,
+// against the running mean of the same windows
+// (writeCircBuf() and getCircBufMeanQ8()). Each sample is
+// followed by a query, as the Hampel filter queries the median
+// for every sample. The samples are noisy 12-bit ADC values.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include "benchTimer.h"
+#include "circBufT.h"
+#include "slidingMedian.h"
+
+#define SEQUENCE_SAMPLES 4096       // Power of 2
+#define SAMPLES 10000000
+
+SLIDING_MEDIAN_STATIC(median15, 15);
+SLIDING_MEDIAN_STATIC(median40, 40);
+SLIDING_MEDIAN_STATIC(median128, 128);
+CIRCBUF_STATIC(mean15, 15);
+CIRCBUF_STATIC(mean40, 40);
+CIRCBUF_STATIC(mean128, 128);
+
+static uint16_t samples[SEQUENCE_SAMPLES];
+
+
+//*****************************************************************************
+//
+// Prints the cost of a timed run.
+//
+//*****************************************************************************
+static void report(const char *name, int window, uint64_t nanos, uint64_t cycles) {
+    printf("%s %3d: %.2f ns/sample, %.2f host cycles/sample\n", name, window,
+           (double) nanos / SAMPLES, (double) cycles / SAMPLES);
+}
+
+
+//*****************************************************************************
+//
+// Times the running median.
+//
+//*****************************************************************************
+static void benchMedian(slidingMedian_t *filter) {
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t median = 0;
+    uint32_t i;
+
+    initSlidingMedian(filter);
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < SAMPLES; i++) {
+        insertSlidingMedian(filter, samples[i & (SEQUENCE_SAMPLES - 1)]);
+        median += getSlidingMedian(filter);
+    }
+    report("Median", filter->size, benchNanos() - nanos, benchCycles() - cycles);
+    BENCH_KEEP(median);
+}
+
+
+//*****************************************************************************
+//
+// Times the running mean.
+//
+//*****************************************************************************
+static void benchMean(circBuf_t *buffer) {
+    uint64_t nanos;
+    uint64_t cycles;
+    uint32_t mean = 0;
+    uint32_t i;
+
+    nanos = benchNanos();
+    cycles = benchCycles();
+    for (i = 0; i < SAMPLES; i++) {
+        writeCircBuf(buffer, samples[i & (SEQUENCE_SAMPLES - 1)]);
+        mean += getCircBufMeanQ8(buffer);
+    }
+    report("Mean  ", buffer->size, benchNanos() - nanos, benchCycles() - cycles);
+    BENCH_KEEP(mean);
+}
+
+
+int main(void) {
+    uint32_t random = 12345;
+    uint32_t i;
+
+    // About 2000 counts with +/- 16 counts of noise
+    for (i = 0; i < SEQUENCE_SAMPLES; i++) {
+        random = random * 1664525u + 1013904223u;
+        samples[i] = 1984 + (random >> 27);
+    }
+
+    benchMedian(&median15);
+    benchMean(&mean15);
+    benchMedian(&median40);
+    benchMean(&mean40);
+    benchMedian(&median128);
+    benchMean(&mean128);
+    return 0;
+}
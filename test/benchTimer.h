@@ -0,0 +1,53 @@
+#ifndef BENCHTIMER_H_
+#define BENCHTIMER_H_
+
+// *******************************************************
+//
+// benchTimer.h
+//
+// Timing for the host benchmarks. Times are from the
+// monotonic clock. On x86 the time stamp counter is read as
+// well. Host figures show relative costs only; the Cortex-M4
+// at 20 MHz has to be measured on the target.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Stops the compiler optimising away a result
+#define BENCH_KEEP(x) __asm volatile ("" : : "r" (x) : "memory")
+
+
+//*****************************************************************************
+//
+// Returns the monotonic clock in nanoseconds.
+//
+//*****************************************************************************
+static inline uint64_t benchNanos(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+
+//*****************************************************************************
+//
+// Returns the host cycle counter, or 0 where there is none.
+//
+//*****************************************************************************
+static inline uint64_t benchCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+#endif /*BENCHTIMER_H_*/
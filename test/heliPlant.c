@@ -0,0 +1,74 @@
+// *******************************************************
+//
+// heliPlant.c
+//
+// Simple model of the helicopter rig for the host
+// simulations.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "heliPlant.h"
+
+#define PLANT_DT (1.0 / PLANT_RATE_HZ)
+
+
+//*****************************************************************************
+//
+// Starts the plant in a steady hover, with the tail cancelling the torque.
+//
+//*****************************************************************************
+void initPlant(heliPlant_t *plant, double height, double yaw, double noise) {
+    plant->mainThrust = PLANT_HOVER_DUTY;
+    plant->tailThrust = PLANT_COUPLING * PLANT_HOVER_DUTY;
+    plant->height = height;
+    plant->climbRate = 0.0;
+    plant->yaw = yaw;
+    plant->yawRate = 0.0;
+    plant->noise = noise;
+    plant->seed = 12345;
+}
+
+
+//*****************************************************************************
+//
+// Advances the plant by one step.
+//
+//*****************************************************************************
+void stepPlant(heliPlant_t *plant, double mainDuty, double tailDuty) {
+    double climbAcceleration;
+    double yawAcceleration;
+
+    plant->mainThrust += (mainDuty - plant->mainThrust) * PLANT_DT / PLANT_MAIN_TAU;
+    plant->tailThrust += (tailDuty - plant->tailThrust) * PLANT_DT / PLANT_TAIL_TAU;
+
+    climbAcceleration = PLANT_ALTITUDE_GAIN * (plant->mainThrust - PLANT_HOVER_DUTY)
+                        - PLANT_ALTITUDE_DAMPING * plant->climbRate;
+    plant->climbRate += climbAcceleration * PLANT_DT;
+    plant->height += plant->climbRate * PLANT_DT;
+    if (plant->height <= 0.0) {
+        plant->height = 0.0;
+        if (plant->climbRate < 0.0) {
+            plant->climbRate = 0.0;
+        }
+    }
+
+    yawAcceleration = PLANT_YAW_GAIN * (plant->tailThrust - PLANT_COUPLING * plant->mainThrust)
+                      - PLANT_YAW_DAMPING * plant->yawRate;
+    plant->yawRate += yawAcceleration * PLANT_DT;
+    plant->yaw += plant->yawRate * PLANT_DT;
+}
+
+
+//*****************************************************************************
+//
+// Returns the measured altitude with noise from a linear congruential
+// sequence.
+//
+//*****************************************************************************
+double measurePlantHeight(heliPlant_t *plant) {
+    plant->seed = plant->seed * 1664525u + 1013904223u;
+    return plant->height + plant->noise * ((double)(plant->seed >> 8) / (1u << 23) - 1.0);
+}
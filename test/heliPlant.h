@@ -0,0 +1,80 @@
+#ifndef HELIPLANT_H_
+#define HELIPLANT_H_
+
+// *******************************************************
+//
+// heliPlant.h
+//
+// Simple model of the helicopter rig for the host
+// simulations. It is not identified from the rig. The
+// numbers are chosen to give the same kind of response (a
+// hover duty near 40%, a few seconds to climb 10%, main
+// rotor torque that the tail must cancel), so controllers
+// and references can be compared with each other. It is not
+// for predicting absolute times on the rig.
+//
+// Each rotor's thrust follows its duty through a first-order
+// lag. The altitude (percent) is driven by the main thrust
+// above the hover duty, with damping, and stops at the ground
+// (0%). The yaw (slots) is driven by the tail thrust less
+// PLANT_COUPLING times the main thrust, with damping.
+//
+// The model is stepped with Euler integration at
+// PLANT_RATE_HZ. The measured altitude adds uniform noise of
+// +/- noise percent from a fixed pseudo-random sequence, so
+// runs repeat exactly.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define PLANT_RATE_HZ 1000
+
+#define PLANT_MAIN_TAU 0.15         // Main thrust lag, s
+#define PLANT_TAIL_TAU 0.08         // Tail thrust lag, s
+#define PLANT_HOVER_DUTY 40.0       // Main duty that holds the altitude, percent
+#define PLANT_ALTITUDE_GAIN 2.0     // Percent/s^2 per percent of duty above hover
+#define PLANT_ALTITUDE_DAMPING 1.0  // Per s
+#define PLANT_COUPLING 0.8          // Tail duty per main duty to cancel the torque
+#define PLANT_YAW_GAIN 15.0         // Slots/s^2 per percent of net tail duty
+#define PLANT_YAW_DAMPING 1.5       // Per s
+
+typedef struct {
+    double mainThrust;          // Lagged main duty, percent
+    double tailThrust;          // Lagged tail duty, percent
+    double height;              // Percent
+    double climbRate;           // Percent/s
+    double yaw;                 // Slots
+    double yawRate;             // Slots/s
+    double noise;               // Altitude measurement noise, +/- percent
+    uint32_t seed;              // Noise sequence state
+} heliPlant_t;
+
+
+//*****************************************************************************
+//
+// Starts the plant in a steady hover at the passed altitude and yaw, with
+// the passed measurement noise.
+//
+//*****************************************************************************
+void initPlant(heliPlant_t *plant, double height, double yaw, double noise);
+
+
+//*****************************************************************************
+//
+// Advances the plant by one PLANT_RATE_HZ step with the passed duties.
+//
+//*****************************************************************************
+void stepPlant(heliPlant_t *plant, double mainDuty, double tailDuty);
+
+
+//*****************************************************************************
+//
+// Returns the measured altitude, percent, with noise.
+//
+//*****************************************************************************
+double measurePlantHeight(heliPlant_t *plant);
+
+#endif /*HELIPLANT_H_*/
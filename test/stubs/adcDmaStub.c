@@ -0,0 +1,265 @@
+// *******************************************************
+//
+// adcDmaStub.c
+//
+// Host stand-ins for the TivaWare ADC, timer and uDMA
+// functions used by adcSampler.c, simulating ADC0 sequence 3
+// and its uDMA channel (see simAdc.h). Only sequence 3 and the
+// ADC3 channel are simulated; calls for anything else are
+// ignored.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "simAdc.h"
+
+#define SIM_SEQUENCE 3
+
+// One uDMA channel control structure
+typedef struct {
+    uint32_t mode;
+    uint16_t *destination;
+    uint32_t count;                 // Transfers to make
+    uint32_t done;                  // Transfers made
+} simDmaStructure_t;
+
+bool simAdcInterruptEachConversion;
+
+static bool sequenceEnabled;
+static bool sequenceDma;
+static bool interruptEnabled;
+static void (*interruptHandler)(void);
+static uint32_t fifo;
+static uint32_t interrupts;
+
+static bool dmaEnabled;
+static bool channelEnabled;
+static simDmaStructure_t structures[2];     // Primary and alternate
+static uint32_t activeStructure;
+static uint32_t lost;
+
+
+//*****************************************************************************
+//
+// Raises the sequence 3 interrupt, calling its handler if it is enabled.
+//
+//*****************************************************************************
+static void raiseInterrupt(void) {
+    interrupts++;
+    if (interruptEnabled && interruptHandler != 0) {
+        interruptHandler();
+    }
+}
+
+
+//*****************************************************************************
+//
+// Makes one conversion, moving it with the uDMA if it is enabled for the
+// sequence, or leaving it in the FIFO.
+//
+//*****************************************************************************
+void simConvert(uint16_t sample) {
+    simDmaStructure_t *structure = &structures[activeStructure];
+    bool complete = false;
+
+    if (!sequenceEnabled) {
+        return;
+    }
+
+    if (sequenceDma && dmaEnabled && channelEnabled) {
+        if (structure->mode == UDMA_MODE_STOP) {
+            lost++;
+        } else {
+            structure->destination[structure->done++] = sample;
+            if (structure->done == structure->count) {
+                structure->mode = UDMA_MODE_STOP;
+                activeStructure ^= 1;
+                complete = true;
+            }
+        }
+        if (complete || simAdcInterruptEachConversion) {
+            raiseInterrupt();
+        }
+    } else {
+        fifo = sample;
+        raiseInterrupt();
+    }
+}
+
+
+//*****************************************************************************
+//
+// Returns the number of sequence 3 interrupts raised.
+//
+//*****************************************************************************
+uint32_t simAdcInterrupts(void) {
+    return interrupts;
+}
+
+
+//*****************************************************************************
+//
+// Returns the number of samples lost with the uDMA channel stalled.
+//
+//*****************************************************************************
+uint32_t simDmaLost(void) {
+    return lost;
+}
+
+
+//*****************************************************************************
+//
+// ADC stand-ins.
+//
+//*****************************************************************************
+void ADCSequenceConfigure(uint32_t base, uint32_t sequence, uint32_t trigger, uint32_t priority) {
+    (void) base;
+    (void) trigger;
+    (void) priority;
+    if (sequence == SIM_SEQUENCE) {
+        sequenceEnabled = false;
+        sequenceDma = false;
+    }
+}
+
+void ADCSequenceStepConfigure(uint32_t base, uint32_t sequence, uint32_t step, uint32_t config) {
+    (void) base;
+    (void) sequence;
+    (void) step;
+    (void) config;
+}
+
+void ADCSequenceEnable(uint32_t base, uint32_t sequence) {
+    (void) base;
+    if (sequence == SIM_SEQUENCE) {
+        sequenceEnabled = true;
+    }
+}
+
+void ADCSequenceDMAEnable(uint32_t base, uint32_t sequence) {
+    (void) base;
+    if (sequence == SIM_SEQUENCE) {
+        sequenceDma = true;
+    }
+}
+
+int32_t ADCSequenceDataGet(uint32_t base, uint32_t sequence, uint32_t *buffer) {
+    (void) base;
+    if (sequence != SIM_SEQUENCE) {
+        return 0;
+    }
+    *buffer = fifo;
+    return 1;
+}
+
+void ADCHardwareOversampleConfigure(uint32_t base, uint32_t factor) {
+    (void) base;
+    (void) factor;
+}
+
+void ADCIntRegister(uint32_t base, uint32_t sequence, void (*handler)(void)) {
+    (void) base;
+    if (sequence == SIM_SEQUENCE) {
+        interruptHandler = handler;
+    }
+}
+
+void ADCIntEnable(uint32_t base, uint32_t sequence) {
+    (void) base;
+    if (sequence == SIM_SEQUENCE) {
+        interruptEnabled = true;
+    }
+}
+
+void ADCIntClear(uint32_t base, uint32_t sequence) {
+    (void) base;
+    (void) sequence;
+}
+
+void ADCProcessorTrigger(uint32_t base, uint32_t sequence) {
+    (void) base;
+    (void) sequence;
+}
+
+
+//*****************************************************************************
+//
+// Timer stand-ins. The conversions are made by simConvert().
+//
+//*****************************************************************************
+void TimerConfigure(uint32_t base, uint32_t config) {
+    (void) base;
+    (void) config;
+}
+
+void TimerLoadSet(uint32_t base, uint32_t timer, uint32_t value) {
+    (void) base;
+    (void) timer;
+    (void) value;
+}
+
+void TimerControlTrigger(uint32_t base, uint32_t timer, bool enable) {
+    (void) base;
+    (void) timer;
+    (void) enable;
+}
+
+void TimerEnable(uint32_t base, uint32_t timer) {
+    (void) base;
+    (void) timer;
+}
+
+
+//*****************************************************************************
+//
+// uDMA stand-ins, for the ADC3 channel.
+//
+//*****************************************************************************
+void uDMAEnable(void) {
+    dmaEnabled = true;
+}
+
+void uDMAControlBaseSet(void *controlTable) {
+    (void) controlTable;
+}
+
+void uDMAChannelAttributeDisable(uint32_t channel, uint32_t attributes) {
+    (void) channel;
+    (void) attributes;
+}
+
+void uDMAChannelControlSet(uint32_t channelStructure, uint32_t control) {
+    (void) channelStructure;
+    (void) control;
+}
+
+void uDMAChannelTransferSet(uint32_t channelStructure, uint32_t mode, void *source, void *destination,
+                            uint32_t count) {
+    simDmaStructure_t *structure = &structures[(channelStructure & UDMA_ALT_SELECT) ? 1 : 0];
+
+    (void) source;
+    if ((channelStructure & ~UDMA_ALT_SELECT) != UDMA_CHANNEL_ADC3) {
+        return;
+    }
+    structure->mode = mode;
+    structure->destination = destination;
+    structure->count = count;
+    structure->done = 0;
+}
+
+void uDMAChannelEnable(uint32_t channel) {
+    if (channel == UDMA_CHANNEL_ADC3) {
+        channelEnabled = true;
+        activeStructure = 0;
+    }
+}
+
+uint32_t uDMAChannelModeGet(uint32_t channelStructure) {
+    return structures[(channelStructure & UDMA_ALT_SELECT) ? 1 : 0].mode;
+}
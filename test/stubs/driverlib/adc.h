@@ -0,0 +1,37 @@
+#ifndef ADC_STUB_H_
+#define ADC_STUB_H_
+
+// *******************************************************
+//
+// adc.h
+//
+// Host stand-in for the TivaWare driverlib/adc.h, with only
+// what adcSampler.c uses. ADC0 sequence 3 is simulated by
+// adcDmaStub.c (see simAdc.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADC_TRIGGER_PROCESSOR 0x00000000
+#define ADC_TRIGGER_TIMER 0x00000005
+
+#define ADC_CTL_CH9 0x00000009
+#define ADC_CTL_END 0x00000020
+#define ADC_CTL_IE 0x00000040
+
+void ADCSequenceConfigure(uint32_t base, uint32_t sequence, uint32_t trigger, uint32_t priority);
+void ADCSequenceStepConfigure(uint32_t base, uint32_t sequence, uint32_t step, uint32_t config);
+void ADCSequenceEnable(uint32_t base, uint32_t sequence);
+void ADCSequenceDMAEnable(uint32_t base, uint32_t sequence);
+int32_t ADCSequenceDataGet(uint32_t base, uint32_t sequence, uint32_t *buffer);
+void ADCHardwareOversampleConfigure(uint32_t base, uint32_t factor);
+void ADCIntRegister(uint32_t base, uint32_t sequence, void (*handler)(void));
+void ADCIntEnable(uint32_t base, uint32_t sequence);
+void ADCIntClear(uint32_t base, uint32_t sequence);
+void ADCProcessorTrigger(uint32_t base, uint32_t sequence);
+
+#endif /*ADC_STUB_H_*/
@@ -0,0 +1,30 @@
+#ifndef EEPROM_STUB_H_
+#define EEPROM_STUB_H_
+
+// *******************************************************
+//
+// eeprom.h
+//
+// Host stand-in for the TivaWare driverlib/eeprom.h. The
+// EEPROM is an array in RAM (driverlibStub.c), which keeps its
+// contents while a test re-initialises the module using it, as
+// the real EEPROM does across a reset. It starts erased (all
+// ones).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define EEPROM_INIT_OK 0
+#define EEPROM_STUB_BYTES 2048
+
+// The stand-in EEPROM, for tests to inspect or corrupt
+extern uint8_t eepromStub[EEPROM_STUB_BYTES];
+
+uint32_t EEPROMInit(void);
+void EEPROMRead(uint32_t *data, uint32_t address, uint32_t count);
+uint32_t EEPROMProgram(uint32_t *data, uint32_t address, uint32_t count);
+
+#endif /*EEPROM_STUB_H_*/
@@ -0,0 +1,37 @@
+#ifndef GPIO_STUB_H_
+#define GPIO_STUB_H_
+
+// *******************************************************
+//
+// gpio.h
+//
+// Host stand-in for the TivaWare driverlib/gpio.h, with only
+// what yaw.c uses (yawStub.c). The pins read the simulated data
+// register, and simQuadratureEdge() (simYaw.h) calls the
+// registered handler.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define GPIO_PIN_0 0x00000001
+#define GPIO_PIN_1 0x00000002
+#define GPIO_PIN_6 0x00000040
+#define GPIO_PIN_7 0x00000080
+
+#define GPIO_INT_PIN_0 0x00000001
+#define GPIO_INT_PIN_1 0x00000002
+
+#define GPIO_BOTH_EDGES 0x00000001
+
+void GPIOPinTypeGPIOInput(uint32_t port, uint8_t pins);
+void GPIOPinTypeQEI(uint32_t port, uint8_t pins);
+void GPIOPinConfigure(uint32_t pinConfig);
+void GPIOIntEnable(uint32_t port, uint32_t intFlags);
+void GPIOIntTypeSet(uint32_t port, uint8_t pins, uint32_t intType);
+void GPIOIntRegister(uint32_t port, void (*handler)(void));
+int32_t GPIOPinRead(uint32_t port, uint8_t pins);
+
+#endif /*GPIO_STUB_H_*/
@@ -0,0 +1,21 @@
+#ifndef INTERRUPT_STUB_H_
+#define INTERRUPT_STUB_H_
+
+// *******************************************************
+//
+// interrupt.h
+//
+// Host stand-in for the TivaWare driverlib/interrupt.h, with
+// only the priority mask (BASEPRI) yaw.c raises. The host has
+// no interrupts, so the mask is only recorded (yawStub.c).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+uint32_t IntPriorityMaskGet(void);
+void IntPriorityMaskSet(uint32_t priorityMask);
+
+#endif /*INTERRUPT_STUB_H_*/
@@ -0,0 +1,18 @@
+#ifndef PIN_MAP_STUB_H_
+#define PIN_MAP_STUB_H_
+
+// *******************************************************
+//
+// pin_map.h
+//
+// Host stand-in for the TivaWare driverlib/pin_map.h, with only
+// the QEI0 pins yaw.c configures.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#define GPIO_PD6_PHA0 0x00031806
+#define GPIO_PD7_PHB0 0x00031C06
+
+#endif /*PIN_MAP_STUB_H_*/
@@ -0,0 +1,35 @@
+#ifndef QEI_STUB_H_
+#define QEI_STUB_H_
+
+// *******************************************************
+//
+// qei.h
+//
+// Host stand-in for the TivaWare driverlib/qei.h, with only
+// what yaw.c uses. QEI0 is simulated by qeiStub.c (see
+// simYaw.h): the position counter and its wrap, and the
+// velocity count latched each velocity period.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define QEI_CONFIG_CAPTURE_A_B 0x00000008
+#define QEI_CONFIG_NO_RESET 0x00000000
+#define QEI_CONFIG_QUADRATURE 0x00000000
+#define QEI_CONFIG_SWAP 0x00000002
+
+#define QEI_VELDIV_1 0x00000000
+
+void QEIConfigure(uint32_t base, uint32_t config, uint32_t maxPosition);
+void QEIVelocityConfigure(uint32_t base, uint32_t preDiv, uint32_t period);
+void QEIPositionSet(uint32_t base, uint32_t position);
+uint32_t QEIPositionGet(uint32_t base);
+void QEIVelocityEnable(uint32_t base);
+void QEIEnable(uint32_t base);
+uint32_t QEIVelocityGet(uint32_t base);
+int32_t QEIDirectionGet(uint32_t base);
+
+#endif /*QEI_STUB_H_*/
@@ -0,0 +1,30 @@
+#ifndef SYSCTL_STUB_H_
+#define SYSCTL_STUB_H_
+
+// *******************************************************
+//
+// sysctl.h
+//
+// Host stand-in for the TivaWare driverlib/sysctl.h, with only
+// what the modules under test use (driverlibStub.c). Enabling
+// a peripheral does nothing, and the clock is 20 MHz.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define SYSCTL_PERIPH_TIMER0 0xf0000400
+#define SYSCTL_PERIPH_TIMER2 0xf0000402
+#define SYSCTL_PERIPH_GPIOB 0xf0000801
+#define SYSCTL_PERIPH_GPIOD 0xf0000803
+#define SYSCTL_PERIPH_UDMA 0xf0000c00
+#define SYSCTL_PERIPH_ADC0 0xf0003800
+#define SYSCTL_PERIPH_QEI0 0xf0004400
+#define SYSCTL_PERIPH_EEPROM0 0xf0005800
+
+void SysCtlPeripheralEnable(uint32_t peripheral);
+uint32_t SysCtlClockGet(void);
+
+#endif /*SYSCTL_STUB_H_*/
@@ -0,0 +1,30 @@
+#ifndef TIMER_STUB_H_
+#define TIMER_STUB_H_
+
+// *******************************************************
+//
+// timer.h
+//
+// Host stand-in for the TivaWare driverlib/timer.h, with only
+// what adcSampler.c and timestamp.c use. The timers do
+// nothing; the tests make each conversion with simConvert()
+// (simAdc.h), and set the timestamp with simSetTimestamp()
+// (simYaw.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMER_CFG_PERIODIC 0x00000022
+#define TIMER_CFG_PERIODIC_UP 0x00000032
+#define TIMER_A 0x000000ff
+
+void TimerConfigure(uint32_t base, uint32_t config);
+void TimerLoadSet(uint32_t base, uint32_t timer, uint32_t value);
+void TimerControlTrigger(uint32_t base, uint32_t timer, bool enable);
+void TimerEnable(uint32_t base, uint32_t timer);
+
+#endif /*TIMER_STUB_H_*/
@@ -0,0 +1,43 @@
+#ifndef UDMA_STUB_H_
+#define UDMA_STUB_H_
+
+// *******************************************************
+//
+// udma.h
+//
+// Host stand-in for the TivaWare driverlib/udma.h, with only
+// what adcSampler.c uses. The ADC0 sequence 3 channel is
+// simulated by adcDmaStub.c (see simAdc.h), in the basic and
+// ping-pong modes.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+#define UDMA_CHANNEL_ADC3 17
+#define UDMA_PRI_SELECT 0x00000000
+#define UDMA_ALT_SELECT 0x00000020
+
+#define UDMA_MODE_STOP 0x00000000
+#define UDMA_MODE_BASIC 0x00000001
+#define UDMA_MODE_PINGPONG 0x00000003
+
+#define UDMA_ATTR_ALL 0x0000000f
+
+#define UDMA_SIZE_16 0x11000000
+#define UDMA_SRC_INC_NONE 0x0c000000
+#define UDMA_DST_INC_16 0x40000000
+#define UDMA_ARB_1 0x00000000
+
+void uDMAEnable(void);
+void uDMAControlBaseSet(void *controlTable);
+void uDMAChannelAttributeDisable(uint32_t channel, uint32_t attributes);
+void uDMAChannelControlSet(uint32_t channelStructure, uint32_t control);
+void uDMAChannelTransferSet(uint32_t channelStructure, uint32_t mode, void *source, void *destination,
+                            uint32_t count);
+void uDMAChannelEnable(uint32_t channel);
+uint32_t uDMAChannelModeGet(uint32_t channelStructure);
+
+#endif /*UDMA_STUB_H_*/
@@ -0,0 +1,73 @@
+// *******************************************************
+//
+// driverlibStub.c
+//
+// Host stand-ins for the TivaWare driverlib functions used by
+// the modules under test. The EEPROM is an array in RAM.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <string.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+
+uint8_t eepromStub[EEPROM_STUB_BYTES];
+static int eepromErased;
+
+
+//*****************************************************************************
+//
+// Enabling a peripheral does nothing on the host.
+//
+//*****************************************************************************
+void SysCtlPeripheralEnable(uint32_t peripheral) {
+    (void) peripheral;
+}
+
+
+//*****************************************************************************
+//
+// The system clock of the helicopter build, 20 MHz.
+//
+//*****************************************************************************
+uint32_t SysCtlClockGet(void) {
+    return 20000000;
+}
+
+
+//*****************************************************************************
+//
+// Erases the stand-in EEPROM on first use.
+//
+//*****************************************************************************
+uint32_t EEPROMInit(void) {
+    if (!eepromErased) {
+        memset(eepromStub, 0xff, sizeof(eepromStub));
+        eepromErased = 1;
+    }
+    return EEPROM_INIT_OK;
+}
+
+
+//*****************************************************************************
+//
+// Reads count bytes from the byte address.
+//
+//*****************************************************************************
+void EEPROMRead(uint32_t *data, uint32_t address, uint32_t count) {
+    memcpy(data, &eepromStub[address], count);
+}
+
+
+//*****************************************************************************
+//
+// Writes count bytes to the byte address.
+//
+//*****************************************************************************
+uint32_t EEPROMProgram(uint32_t *data, uint32_t address, uint32_t count) {
+    memcpy(&eepromStub[address], data, count);
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef HW_ADC_STUB_H_
+#define HW_ADC_STUB_H_
+
+// *******************************************************
+//
+// hw_adc.h
+//
+// Host stand-in for the TivaWare inc/hw_adc.h, with only the
+// register offsets the modules under test use.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#define ADC_O_SSFIFO3 0x000000A8     // Sequence 3 result FIFO
+
+#endif /*HW_ADC_STUB_H_*/
@@ -0,0 +1,23 @@
+#ifndef HW_GPIO_STUB_H_
+#define HW_GPIO_STUB_H_
+
+// *******************************************************
+//
+// hw_gpio.h
+//
+// Host stand-in for the TivaWare inc/hw_gpio.h, with only the
+// register offsets and values yaw.c uses.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#define GPIO_O_DATA 0x00000000
+#define GPIO_O_ICR 0x0000041C
+#define GPIO_O_LOCK 0x00000520
+#define GPIO_O_CR 0x00000524
+
+#define GPIO_LOCK_M 0xFFFFFFFF
+#define GPIO_LOCK_KEY 0x4C4F434B
+
+#endif /*HW_GPIO_STUB_H_*/
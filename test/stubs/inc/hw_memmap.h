@@ -0,0 +1,22 @@
+#ifndef HW_MEMMAP_STUB_H_
+#define HW_MEMMAP_STUB_H_
+
+// *******************************************************
+//
+// hw_memmap.h
+//
+// Host stand-in for the TivaWare inc/hw_memmap.h, with only the
+// peripheral bases the modules under test use.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#define GPIO_PORTB_BASE 0x40005000
+#define GPIO_PORTD_BASE 0x40007000
+#define QEI0_BASE 0x4002C000
+#define TIMER0_BASE 0x40030000
+#define TIMER2_BASE 0x40032000
+#define ADC0_BASE 0x40038000
+
+#endif /*HW_MEMMAP_STUB_H_*/
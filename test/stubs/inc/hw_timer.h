@@ -0,0 +1,17 @@
+#ifndef HW_TIMER_STUB_H_
+#define HW_TIMER_STUB_H_
+
+// *******************************************************
+//
+// hw_timer.h
+//
+// Host stand-in for the TivaWare inc/hw_timer.h, with only the
+// timer A count register that timestamp.h reads.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#define TIMER_O_TAR 0x00000048
+
+#endif /*HW_TIMER_STUB_H_*/
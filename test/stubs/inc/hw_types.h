@@ -0,0 +1,29 @@
+#ifndef HW_TYPES_STUB_H_
+#define HW_TYPES_STUB_H_
+
+// *******************************************************
+//
+// hw_types.h
+//
+// Host stand-in for the TivaWare inc/hw_types.h. HWREG()
+// accesses a simulated register word (yawStub.c), which the
+// simulations set and read.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HWREG(x) (*simRegister(x))
+
+
+//*****************************************************************************
+//
+// Returns the simulated register word at an address, zero until written.
+//
+//*****************************************************************************
+volatile uint32_t *simRegister(uint32_t address);
+
+#endif /*HW_TYPES_STUB_H_*/
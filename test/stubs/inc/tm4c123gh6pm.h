@@ -0,0 +1,23 @@
+#ifndef TM4C123GH6PM_STUB_H_
+#define TM4C123GH6PM_STUB_H_
+
+// *******************************************************
+//
+// tm4c123gh6pm.h
+//
+// Host stand-in for the TivaWare inc/tm4c123gh6pm.h, with only
+// the port D lock registers yaw.c unlocks PD7 with. They are
+// simulated register words (hw_types.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+
+#define GPIO_PORTD_LOCK_R HWREG(GPIO_PORTD_BASE + GPIO_O_LOCK)
+#define GPIO_PORTD_CR_R HWREG(GPIO_PORTD_BASE + GPIO_O_CR)
+
+#endif /*TM4C123GH6PM_STUB_H_*/
@@ -0,0 +1,107 @@
+// *******************************************************
+//
+// qeiStub.c
+//
+// Host stand-ins for the TivaWare QEI functions used by yaw.c,
+// simulating QEI0 (see simYaw.h). The configuration is taken
+// as yaw.c sets it: quadrature on both channels, with the
+// channels swapped so that clockwise counts up, and no
+// predivider on the velocity count.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "driverlib/qei.h"
+#include "simYaw.h"
+
+static uint32_t maxPosition;
+static uint32_t position;
+static int32_t direction = 1;
+static uint32_t period;             // Velocity period, cycles
+static uint32_t periodCycles;       // Cycles into the current period
+static uint32_t edges;              // Edges counted in the current period
+static uint32_t velocity;           // Edges counted in the last period
+
+
+//*****************************************************************************
+//
+// Moves the position one count. Counting up from the maximum position gives
+// 0, and counting down from 0 gives the maximum.
+//
+//*****************************************************************************
+void simQeiEdge(int edgeDirection) {
+    direction = (edgeDirection > 0) ? 1 : -1;
+    if (direction > 0) {
+        position = (position >= maxPosition) ? 0 : position + 1;
+    } else {
+        position = (position == 0) ? maxPosition : position - 1;
+    }
+    edges++;
+}
+
+
+//*****************************************************************************
+//
+// Runs the velocity timer, latching the edge count at the end of each
+// period.
+//
+//*****************************************************************************
+void simQeiClock(uint32_t cycles) {
+    periodCycles += cycles;
+    while (period != 0 && periodCycles >= period) {
+        periodCycles -= period;
+        velocity = edges;
+        edges = 0;
+    }
+}
+
+
+//*****************************************************************************
+//
+// QEI0. The base is not checked.
+//
+//*****************************************************************************
+void QEIConfigure(uint32_t base, uint32_t config, uint32_t maxPositionValue) {
+    (void) base;
+    (void) config;
+    maxPosition = maxPositionValue;
+}
+
+void QEIVelocityConfigure(uint32_t base, uint32_t preDiv, uint32_t periodValue) {
+    (void) base;
+    (void) preDiv;
+    period = periodValue;
+    periodCycles = 0;
+    edges = 0;
+    velocity = 0;
+}
+
+void QEIPositionSet(uint32_t base, uint32_t positionValue) {
+    (void) base;
+    position = positionValue;
+}
+
+uint32_t QEIPositionGet(uint32_t base) {
+    (void) base;
+    return position;
+}
+
+void QEIVelocityEnable(uint32_t base) {
+    (void) base;
+}
+
+void QEIEnable(uint32_t base) {
+    (void) base;
+}
+
+uint32_t QEIVelocityGet(uint32_t base) {
+    (void) base;
+    return velocity;
+}
+
+int32_t QEIDirectionGet(uint32_t base) {
+    (void) base;
+    return direction;
+}
@@ -0,0 +1,61 @@
+#ifndef SIMADC_H_
+#define SIMADC_H_
+
+// *******************************************************
+//
+// simAdc.h
+//
+// Simulated ADC0 sequence 3 and its uDMA channel, behind the
+// driverlib stand-ins (adcDmaStub.c), for running adcSampler.c
+// on the host.
+//
+// simConvert() makes one conversion, as the trigger timer
+// would. With the sequence's uDMA enabled, the sample goes to
+// the active structure of the channel, as the TM4C123 uDMA
+// does. When a structure has moved its count it returns to the
+// stop mode, the other structure becomes active, and the
+// sequence 3 interrupt is raised. If the other structure is
+// stopped too, the channel stalls and further samples are lost.
+// Without the uDMA, the sample is left in the FIFO and the
+// interrupt is raised for each conversion.
+//
+// Whether the TM4C123 also raises the sequence interrupt for
+// each conversion when the uDMA is enabled is not confirmed on
+// the board, so simAdcInterruptEachConversion can make it do
+// so.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Set to raise the sequence 3 interrupt for each conversion with the uDMA
+extern bool simAdcInterruptEachConversion;
+
+
+//*****************************************************************************
+//
+// Makes one conversion of the passed sample on ADC0 sequence 3.
+//
+//*****************************************************************************
+void simConvert(uint16_t sample);
+
+
+//*****************************************************************************
+//
+// Returns the number of sequence 3 interrupts raised.
+//
+//*****************************************************************************
+uint32_t simAdcInterrupts(void);
+
+
+//*****************************************************************************
+//
+// Returns the number of samples lost with the uDMA channel stalled.
+//
+//*****************************************************************************
+uint32_t simDmaLost(void);
+
+#endif /*SIMADC_H_*/
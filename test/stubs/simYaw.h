@@ -0,0 +1,73 @@
+#ifndef SIMYAW_H_
+#define SIMYAW_H_
+
+// *******************************************************
+//
+// simYaw.h
+//
+// Simulated yaw encoder and timestamp counter, behind the
+// register and driverlib stand-ins (yawStub.c), for running
+// yaw.c and timestamp.c on the host.
+//
+// With the GPIO backend, simQuadratureEdge() sets the state of
+// PB0 and PB1 and calls the port B handler, as an edge would.
+// The timestamp counter (TIMER2) holds whatever value was last
+// set with simSetTimestamp(), so each edge and each call to
+// updateYawRate() is made at a chosen time.
+//
+// With the QEI backend, simQeiEdge() moves the QEI0 position
+// counter one count, wrapping between 0 and the maximum set by
+// QEIConfigure() as the TM4C123 QEI does, and simQeiClock()
+// runs the velocity timer, which latches the count of edges in
+// each velocity period for QEIVelocityGet() (qeiStub.c).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+
+
+//*****************************************************************************
+//
+// Sets the timestamp counter.
+//
+//*****************************************************************************
+void simSetTimestamp(uint32_t timestamp);
+
+
+//*****************************************************************************
+//
+// Sets the state of the encoder channels on PB0 and PB1 (a yawStates value)
+// and calls the port B interrupt handler if one is registered.
+//
+//*****************************************************************************
+void simQuadratureEdge(uint32_t state);
+
+
+//*****************************************************************************
+//
+// Moves the QEI0 position one count, up for direction 1 and down for -1.
+//
+//*****************************************************************************
+void simQeiEdge(int direction);
+
+
+//*****************************************************************************
+//
+// Runs the QEI0 velocity timer for a number of system clock cycles.
+//
+//*****************************************************************************
+void simQeiClock(uint32_t cycles);
+
+
+//*****************************************************************************
+//
+// Returns the priority mask last set with IntPriorityMaskSet(), and the
+// highest (numerically lowest non-zero) mask set since the last call.
+//
+//*****************************************************************************
+uint32_t simPriorityMask(void);
+uint32_t simHighestPriorityMask(void);
+
+#endif /*SIMYAW_H_*/
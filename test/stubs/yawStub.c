@@ -0,0 +1,162 @@
+// *******************************************************
+//
+// yawStub.c
+//
+// Host stand-ins for the register access and the TivaWare
+// GPIO and interrupt functions used by yaw.c and timestamp.c,
+// simulating the yaw encoder on PB0 and PB1 and the timestamp
+// counter (see simYaw.h). Configuring the pins does nothing.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_timer.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "simYaw.h"
+
+#define SIM_REGISTERS 16
+#define QUADRATURE_PINS (GPIO_PIN_0 | GPIO_PIN_1)
+
+// One simulated register word
+typedef struct {
+    uint32_t address;
+    uint32_t value;
+} simRegister_t;
+
+static simRegister_t registers[SIM_REGISTERS];
+static int registerCount;
+
+static void (*portBHandler)(void);
+
+static uint32_t priorityMask;
+static uint32_t highestPriorityMask;
+
+
+//*****************************************************************************
+//
+// Returns the simulated register word at an address, adding it on first use.
+//
+//*****************************************************************************
+volatile uint32_t *simRegister(uint32_t address) {
+    int i;
+
+    for (i = 0; i < registerCount; i++) {
+        if (registers[i].address == address) {
+            return &registers[i].value;
+        }
+    }
+    if (registerCount == SIM_REGISTERS) {
+        abort();
+    }
+    registers[registerCount].address = address;
+    registers[registerCount].value = 0;
+    return &registers[registerCount++].value;
+}
+
+
+//*****************************************************************************
+//
+// Sets the timestamp counter.
+//
+//*****************************************************************************
+void simSetTimestamp(uint32_t timestamp) {
+    HWREG(TIMER2_BASE + TIMER_O_TAR) = timestamp;
+}
+
+
+//*****************************************************************************
+//
+// Sets PB0 and PB1, read through the masked data register, and raises the
+// port B interrupt.
+//
+//*****************************************************************************
+void simQuadratureEdge(uint32_t state) {
+    HWREG(GPIO_PORTB_BASE + GPIO_O_DATA + (QUADRATURE_PINS << 2)) = state & QUADRATURE_PINS;
+    if (portBHandler != 0) {
+        portBHandler();
+    }
+}
+
+
+//*****************************************************************************
+//
+// Returns the priority mask last set, and the highest one set since the last
+// call.
+//
+//*****************************************************************************
+uint32_t simPriorityMask(void) {
+    return priorityMask;
+}
+
+uint32_t simHighestPriorityMask(void) {
+    uint32_t highest = highestPriorityMask;
+
+    highestPriorityMask = 0;
+    return highest;
+}
+
+
+//*****************************************************************************
+//
+// GPIO. Only the port B interrupt handler and the pin states are simulated.
+//
+//*****************************************************************************
+void GPIOPinTypeGPIOInput(uint32_t port, uint8_t pins) {
+    (void) port;
+    (void) pins;
+}
+
+void GPIOPinTypeQEI(uint32_t port, uint8_t pins) {
+    (void) port;
+    (void) pins;
+}
+
+void GPIOPinConfigure(uint32_t pinConfig) {
+    (void) pinConfig;
+}
+
+void GPIOIntEnable(uint32_t port, uint32_t intFlags) {
+    (void) port;
+    (void) intFlags;
+}
+
+void GPIOIntTypeSet(uint32_t port, uint8_t pins, uint32_t intType) {
+    (void) port;
+    (void) pins;
+    (void) intType;
+}
+
+void GPIOIntRegister(uint32_t port, void (*handler)(void)) {
+    if (port == GPIO_PORTB_BASE) {
+        portBHandler = handler;
+    }
+}
+
+int32_t GPIOPinRead(uint32_t port, uint8_t pins) {
+    return HWREG(port + GPIO_O_DATA + (pins << 2));
+}
+
+
+//*****************************************************************************
+//
+// The priority mask (BASEPRI). Zero masks nothing; otherwise a lower value
+// masks more.
+//
+//*****************************************************************************
+uint32_t IntPriorityMaskGet(void) {
+    return priorityMask;
+}
+
+void IntPriorityMaskSet(uint32_t mask) {
+    priorityMask = mask;
+    if (mask != 0 && (highestPriorityMask == 0 || mask < highestPriorityMask)) {
+        highestPriorityMask = mask;
+    }
+}
@@ -0,0 +1,106 @@
+// *******************************************************
+//
+// testAdcSampler.c
+//
+// Host test of the uDMA acquisition mode of adcSampler.c
+// (ADC_MODE_UDMA), against the simulated ADC and uDMA in
+// stubs/adcDmaStub.c. A slowly varying altitude signal with
+// noise is converted at ADC_OVERSAMPLE_RATE_HZ. The ring must
+// receive exactly the outputs of the CIC decimator run on the
+// same samples, with one interrupt per half buffer and no
+// samples lost. The same must hold if the sequence interrupt
+// also comes for each conversion, which is not confirmed on
+// the TM4C123 (see adcSampler.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "unitTest.h"
+#include "spscBufT.h"
+#include "decimator.h"
+#include "adcSampler.h"
+#include "simAdc.h"
+
+#define SECONDS 2
+#define SAMPLES (SECONDS * ADC_OVERSAMPLE_RATE_HZ)
+#define OUTPUTS (SAMPLES / CIC_DECIMATION)
+#define RING_SIZE 256
+#define PI 3.14159265358979323846
+
+
+//*****************************************************************************
+//
+// Returns the passed conversion of a 12-bit signal: a 1.5 Hz swing around
+// mid-range with up to +/-20 counts of noise.
+//
+//*****************************************************************************
+static uint16_t signalSample(uint32_t n, uint32_t *seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return (uint16_t)(2000.0 + 300.0 * sin(2.0 * PI * 1.5 * n / ADC_OVERSAMPLE_RATE_HZ)
+                      + (double)(*seed >> 24) * 40.0 / 256.0 - 20.0);
+}
+
+
+//*****************************************************************************
+//
+// Converts the signal through adcSampler.c and checks the ring against the
+// decimator run directly on the samples.
+//
+//*****************************************************************************
+static void testAcquisition(bool interruptEachConversion) {
+    static uint32_t storage[RING_SIZE];
+    spscBuf_t ring;
+    cicDecimator_t reference;
+    uint32_t expected[OUTPUTS];
+    uint32_t received[OUTPUTS];
+    uint32_t expectedCount = 0;
+    uint32_t receivedCount = 0;
+    uint32_t interrupts = simAdcInterrupts();
+    uint32_t lost = simDmaLost();
+    uint32_t seed = 7;
+    uint32_t mismatches = 0;
+    uint16_t sample;
+    uint32_t n;
+
+    initSpscBuf(&ring, storage, RING_SIZE);
+    initCicDecimator(&reference);
+    simAdcInterruptEachConversion = interruptEachConversion;
+    initADCSampler(&ring);
+
+    for (n = 0; n < SAMPLES; n++) {
+        sample = signalSample(n, &seed);
+        simConvert(sample);
+        if (cicDecimate(&reference, sample, &expected[expectedCount])) {
+            expectedCount++;
+        }
+        receivedCount += readSpscBuf(&ring, &received[receivedCount], OUTPUTS - receivedCount);
+    }
+
+    CHECK(expectedCount == OUTPUTS);
+    CHECK(receivedCount == OUTPUTS);
+    for (n = 0; n < OUTPUTS && n < receivedCount; n++) {
+        if (received[n] != expected[n]) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(simDmaLost() == lost);
+    CHECK(ring.overruns == 0);
+
+    interrupts = simAdcInterrupts() - interrupts;
+    printf("%s: %u samples, %u outputs, %u interrupts\n",
+           interruptEachConversion ? "Interrupt each conversion" : "Interrupt on completion",
+           (unsigned int) SAMPLES, (unsigned int) receivedCount, (unsigned int) interrupts);
+    CHECK(interrupts == (interruptEachConversion ? SAMPLES : SAMPLES / ADC_BLOCK_SIZE));
+}
+
+
+int main(void) {
+    testAcquisition(false);
+    testAcquisition(true);
+    return TEST_RESULT();
+}
@@ -0,0 +1,195 @@
+// *******************************************************
+//
+// testAltitudeKalman.c
+//
+// Host tests for the Kalman altitude estimator
+// (altitudeKalman.c) on the plant model (heliPlant.h). The
+// measured altitude, with +/- PLANT_NOISE percent of noise, is
+// turned into ADC samples as the rig's sensor would give them,
+// KALMAN_SAMPLES_PER_STEP at a time at the ring rate, and fed
+// to updateAltitudeKalman() with the main duty. The plant is
+// not the filter's model: its thrust lags the duty, and its
+// gain (2 %/s^2 per %) and damping (1/s) are well below the
+// filter's placeholder constants, so most of the velocity
+// error in the climbs and descents is the model's.
+//
+// Started at zero while the plant hovers at 40%, the estimate
+// must come within HEIGHT_ERROR_MAX and VELOCITY_ERROR_MAX of
+// the plant in CONVERGE_TIME and stay there. Through climbs and
+// descents the RMS errors are printed and bounded. With no
+// noise the filter runs at its smallest innovation variance S,
+// where 2^32 / S must still fit a q16_t, and must settle on the
+// measured altitude.
+//
+// The test is built in the processor triggered mode and in
+// ADC_MODE_MULTISTEP, where each trigger gives a burst of
+// samples.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "altitude.h"
+#include "altitudeKalman.h"
+#include "heliPlant.h"
+
+#define LANDED_ADC 2500
+#define PLANT_NOISE 0.5                     // +/- percent, about 3 ADC counts
+#define TRIGGER_RATE_HZ (ADC_RING_RATE_HZ / KALMAN_SAMPLES_PER_STEP)
+#define TRIGGER_PLANT_STEPS (PLANT_RATE_HZ / TRIGGER_RATE_HZ)
+#define CONVERGE_TIME 2.0                   // s
+#define HEIGHT_ERROR_MAX 0.5                // Percent
+#define VELOCITY_ERROR_MAX 3.0              // Percent/s
+#define TRACKING_HEIGHT_RMS_MAX 0.5         // Percent
+#define TRACKING_VELOCITY_RMS_MAX 5.0       // Percent/s
+
+// Main duty (percent) from a time (s) on, for the tracking test
+typedef struct {
+    double time;
+    int duty;
+} dutyStep_t;
+
+static const dutyStep_t dutySteps[] = {
+    {0.0, 40}, {2.0, 45}, {3.0, 35}, {4.0, 40}, {6.0, 43}, {7.5, 37}, {9.0, 40}, {12.0, 40}
+};
+
+
+//*****************************************************************************
+//
+// Returns the ADC sample of a measured altitude (percent).
+//
+//*****************************************************************************
+static uint32_t toSample(double height) {
+    return (uint32_t) lround(LANDED_ADC - height * MAX_ALTITUDE_BITS / PERCENT_CONVERSION);
+}
+
+
+//*****************************************************************************
+//
+// Runs the plant for one trigger period at the passed duty, then feeds the
+// samples of that trigger to the filter.
+//
+//*****************************************************************************
+static void runTrigger(heliPlant_t *plant, int duty) {
+    int step;
+    int sample;
+
+    for (step = 0; step < TRIGGER_PLANT_STEPS; step++) {
+        stepPlant(plant, duty, PLANT_COUPLING * duty);
+    }
+    for (sample = 0; sample < KALMAN_SAMPLES_PER_STEP; sample++) {
+        updateAltitudeKalman(toSample(measurePlantHeight(plant)), duty);
+    }
+}
+
+
+//*****************************************************************************
+//
+// Starts the estimate at zero with the plant hovering at 40%. It must
+// converge on the plant's altitude and velocity.
+//
+//*****************************************************************************
+static void testConvergence(void) {
+    heliPlant_t plant;
+    double heightError;
+    double velocityError;
+    double worstHeight = 0.0;
+    double worstVelocity = 0.0;
+    int trigger;
+
+    initPlant(&plant, 40.0, 0.0, PLANT_NOISE);
+    initAltitudeKalman(LANDED_ADC);
+
+    for (trigger = 0; trigger < 10 * TRIGGER_RATE_HZ; trigger++) {
+        runTrigger(&plant, PLANT_HOVER_DUTY);
+        if (trigger >= CONVERGE_TIME * TRIGGER_RATE_HZ) {
+            heightError = fabs((double) getKalmanHeight() / Q16_ONE - plant.height);
+            velocityError = fabs((double) getKalmanVelocity() / Q16_ONE - plant.climbRate);
+            worstHeight = (heightError > worstHeight) ? heightError : worstHeight;
+            worstVelocity = (velocityError > worstVelocity) ? velocityError : worstVelocity;
+        }
+    }
+    printf("From zero to a 40%% hover: after %.1f s, largest errors %.3f%% and %.3f%%/s\n",
+           CONVERGE_TIME, worstHeight, worstVelocity);
+    CHECK(worstHeight < HEIGHT_ERROR_MAX);
+    CHECK(worstVelocity < VELOCITY_ERROR_MAX);
+}
+
+
+//*****************************************************************************
+//
+// Follows the plant through climbs and descents from a settled hover.
+//
+//*****************************************************************************
+static void testTracking(void) {
+    const unsigned int steps = sizeof(dutySteps) / sizeof(dutySteps[0]);
+    heliPlant_t plant;
+    double heightSquares = 0.0;
+    double velocitySquares = 0.0;
+    double error;
+    double time;
+    unsigned int step = 0;
+    int trigger;
+    int triggers = (int)(dutySteps[steps - 1].time * TRIGGER_RATE_HZ);
+
+    initPlant(&plant, 40.0, 0.0, PLANT_NOISE);
+    initAltitudeKalman(LANDED_ADC);
+    for (trigger = 0; trigger < 10 * TRIGGER_RATE_HZ; trigger++) {
+        runTrigger(&plant, PLANT_HOVER_DUTY);
+    }
+
+    for (trigger = 0; trigger < triggers; trigger++) {
+        time = (double) trigger / TRIGGER_RATE_HZ;
+        while (step + 1 < steps && time >= dutySteps[step + 1].time) {
+            step++;
+        }
+        runTrigger(&plant, dutySteps[step].duty);
+
+        error = (double) getKalmanHeight() / Q16_ONE - plant.height;
+        heightSquares += error * error;
+        error = (double) getKalmanVelocity() / Q16_ONE - plant.climbRate;
+        velocitySquares += error * error;
+    }
+    heightSquares = sqrt(heightSquares / triggers);
+    velocitySquares = sqrt(velocitySquares / triggers);
+    printf("Climbs and descents: RMS errors %.3f%% and %.3f%%/s (measurement noise %.3f%% RMS)\n",
+           heightSquares, velocitySquares, PLANT_NOISE / sqrt(3.0));
+    CHECK(heightSquares < TRACKING_HEIGHT_RMS_MAX);
+    CHECK(velocitySquares < TRACKING_VELOCITY_RMS_MAX);
+}
+
+
+//*****************************************************************************
+//
+// With no noise the altitude variance falls to its floor, which gives the
+// smallest S. That is at least the measurement noise R, whose inverse must
+// fit a q16_t, and the estimate must settle on the measurement.
+//
+//*****************************************************************************
+static void testSmallestS(void) {
+    heliPlant_t plant;
+    int trigger;
+
+    CHECK(UINT32_MAX / (uint32_t) KALMAN_MEASUREMENT_NOISE <= INT32_MAX);
+
+    initPlant(&plant, 60.0, 0.0, 0.0);
+    initAltitudeKalman(LANDED_ADC);
+    for (trigger = 0; trigger < 60 * TRIGGER_RATE_HZ; trigger++) {
+        runTrigger(&plant, PLANT_HOVER_DUTY);
+    }
+    CHECK_NEAR(getKalmanHeight(), calcAltitudeQ16(LANDED_ADC, toSample(60.0) << 8), Q16(0.01));
+    CHECK_NEAR(getKalmanVelocity(), 0, Q16(0.01));
+}
+
+
+int main(void) {
+    printf("%d sample(s) per step at %d Hz\n", KALMAN_SAMPLES_PER_STEP, TRIGGER_RATE_HZ);
+    testConvergence();
+    testTracking();
+    testSmallestS();
+    return TEST_RESULT();
+}
@@ -0,0 +1,242 @@
+// *******************************************************
+//
+// testAutotune.c
+//
+// Host tests for the relay experiment (autotune.c) and the
+// tuned gain scale (gainSchedule.c). The relay runs at
+// CONTROL_RATE_HZ on the altitude of the plant model
+// (heliPlant.h), with the relay and hysteresis of the
+// altitude experiment in updateAutotune(), as the controller
+// would. The test keeps its own record of the relay switches
+// and error extremes, and the experiment must give
+//      Ku = 4 * amplitude / (pi * sqrt(a^2 - hysteresis^2))
+// from the same cycles within KU_ERROR_MAX, Tu within one
+// tick, and the Ziegler-Nichols gains from them within
+// GAIN_ERROR_MAX. The relay finds the point of the plant's
+// frequency response, at the period it oscillates at, that
+// is -1 / Ku along the real axis. The hysteresis adds phase
+// lag, so this is not the ultimate point of the plant (Ku
+// 3.8, Tu 2.4 s), but the real part of the model's response
+// at the measured Tu must be within PLANT_ERROR_MAX of
+// -1 / Ku.
+//
+// AUTOTUNE must be given the FLYING gains at every altitude.
+// Tuned gains from 1/1000 to 1000 times the table must come
+// back from the schedule at the middle altitude, and gains
+// too large for the Q16 scale must saturate it rather than
+// wrap.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "control.h"
+#include "autotune.h"
+#include "gainSchedule.h"
+#include "heliPlant.h"
+
+#define PI 3.14159265358979323846
+#define REFERENCE_HEIGHT 50.0       // Percent
+#define PLANT_STEPS_PER_TICK (PLANT_RATE_HZ / CONTROL_RATE_HZ)
+#define KU_ERROR_MAX 0.002          // Fraction of Ku from the recorded cycles
+#define GAIN_ERROR_MAX 0.002        // Fraction of each gain from Ku and Tu
+#define PLANT_ERROR_MAX 0.05        // Fraction of 1 / Ku
+#define SCALE_ERROR_MAX 0.002       // Fraction of a tuned gain, or 2 Q16 steps
+
+// Recorded cycles of the relay, measured as autotune.c measures them
+typedef struct {
+    int cycles;                 // Upward switches so far
+    int measured;               // Cycles recorded
+    int cycleStart;             // Tick of the last upward switch
+    double periodTicks;         // Sum of the recorded periods, ticks
+    double peakToPeak;          // Sum of the recorded peak to peak errors
+    double errorMax;
+    double errorMin;
+} relayRecord_t;
+
+
+//*****************************************************************************
+//
+// Returns the real part of the plant's altitude response,
+// PLANT_ALTITUDE_GAIN / (s (s + PLANT_ALTITUDE_DAMPING) (PLANT_MAIN_TAU s + 1)),
+// at a period in seconds.
+//
+//*****************************************************************************
+static double calcPlantReal(double period) {
+    double omega = 2.0 * PI / period;
+    double real = -omega * omega * (1.0 + PLANT_ALTITUDE_DAMPING * PLANT_MAIN_TAU);
+    double imaginary = omega * (PLANT_ALTITUDE_DAMPING - PLANT_MAIN_TAU * omega * omega);
+
+    return PLANT_ALTITUDE_GAIN * real / (real * real + imaginary * imaginary);
+}
+
+
+//*****************************************************************************
+//
+// Checks that a value is within a fraction of what it should be.
+//
+//*****************************************************************************
+static void checkRelative(const char *name, double value, double expected, double fraction) {
+    printf("%-10s %10.4f, expected %10.4f\n", name, value, expected);
+    CHECK(fabs(value - expected) <= fraction * fabs(expected));
+}
+
+
+//*****************************************************************************
+//
+// Runs the altitude relay experiment on the plant, and checks its results.
+//
+//*****************************************************************************
+static void checkRelay(void) {
+    const double amplitude = (double) AUTOTUNE_MAIN_RELAY / Q16_ONE;
+    const double hysteresis = (double) AUTOTUNE_MAIN_HYSTERESIS / Q16_ONE;
+    relayTune_t relay;
+    relayRecord_t record = {0};
+    heliPlant_t plant;
+    pidGains_t gains;
+    double error;
+    double duty;
+    double a;
+    double ku;
+    double tu;
+    bool high = true;
+    int tick = 0;
+    int step;
+
+    initPlant(&plant, REFERENCE_HEIGHT, 0.0, 0.0);
+    startRelay(&relay, Q16(PLANT_HOVER_DUTY), AUTOTUNE_MAIN_RELAY, AUTOTUNE_MAIN_HYSTERESIS,
+               CONTROL_RATE_HZ, AUTOTUNE_TIMEOUT_TICKS);
+
+    while (getRelayState(&relay) == RELAY_RUNNING) {
+        tick++;
+        error = REFERENCE_HEIGHT - measurePlantHeight(&plant);
+        duty = (double) updateRelay(&relay, (q16_t) lround(error * Q16_ONE)) / Q16_ONE;
+
+        // The record, as updateRelay() keeps it
+        if (error > record.errorMax) {
+            record.errorMax = error;
+        }
+        if (error < record.errorMin) {
+            record.errorMin = error;
+        }
+        if (high && error < -hysteresis) {
+            high = false;
+        } else if (!high && error > hysteresis) {
+            high = true;
+            if (record.cycles >= RELAY_SETTLE_CYCLES && record.measured < RELAY_MEASURE_CYCLES) {
+                record.periodTicks += tick - record.cycleStart;
+                record.peakToPeak += record.errorMax - record.errorMin;
+                record.measured++;
+            }
+            record.cycles++;
+            record.cycleStart = tick;
+            record.errorMax = error;
+            record.errorMin = error;
+        }
+
+        for (step = 0; step < PLANT_STEPS_PER_TICK; step++) {
+            stepPlant(&plant, duty, PLANT_COUPLING * PLANT_HOVER_DUTY);
+        }
+    }
+    CHECK(getRelayState(&relay) == RELAY_DONE);
+    CHECK(record.measured == RELAY_MEASURE_CYCLES);
+    if (getRelayState(&relay) != RELAY_DONE || record.measured == 0) {
+        return;
+    }
+
+    a = record.peakToPeak / (2.0 * record.measured);
+    ku = (double) getRelayKu(&relay) / Q16_ONE;
+    tu = (double) getRelayTu(&relay) / Q16_ONE;
+    checkRelative("Ku", ku, 4.0 * amplitude / (PI * sqrt(a * a - hysteresis * hysteresis)),
+                  KU_ERROR_MAX);
+    CHECK(fabs(tu - record.periodTicks / (record.measured * CONTROL_RATE_HZ)) <= 1.0 / CONTROL_RATE_HZ);
+
+    checkRelative("Plant Re", calcPlantReal(tu), -1.0 / ku, PLANT_ERROR_MAX);
+
+    calcRelayPID(&relay, &gains);
+    checkRelative("PID Kp", (double) gains.kp / Q16_ONE, 0.6 * ku, GAIN_ERROR_MAX);
+    checkRelative("PID Ki", (double) gains.ki / Q16_ONE, 1.2 * ku / tu, GAIN_ERROR_MAX);
+    checkRelative("PID Kd", (double) gains.kd / Q16_ONE, 0.075 * ku * tu, GAIN_ERROR_MAX);
+    calcRelayPI(&relay, &gains);
+    checkRelative("PI Kp", (double) gains.kp / Q16_ONE, 0.45 * ku, GAIN_ERROR_MAX);
+    checkRelative("PI Ki", (double) gains.ki / Q16_ONE, 0.54 * ku / tu, GAIN_ERROR_MAX);
+    CHECK(gains.kd == 0);
+}
+
+
+//*****************************************************************************
+//
+// Checks that one tuned gain comes back from the schedule, within
+// SCALE_ERROR_MAX or two Q16 steps.
+//
+//*****************************************************************************
+static void checkTunedGain(q16_t tuned, q16_t gain) {
+    double tolerance = SCALE_ERROR_MAX * fabs((double) tuned);
+
+    if (tolerance < 2.0) {
+        tolerance = 2.0;
+    }
+    CHECK(fabs((double) gain - tuned) <= tolerance);
+}
+
+
+//*****************************************************************************
+//
+// Sets tuned main gains a multiple of the table gains, and checks they come
+// back from the schedule at the middle altitude in FLYING.
+//
+//*****************************************************************************
+static void checkScale(double multiple) {
+    pidGains_t tuned;
+    pidGains_t gains;
+
+    tuned.kp = (q16_t) lround(KpMain * multiple);
+    tuned.ki = (q16_t) lround(KiMain * multiple);
+    tuned.kd = (q16_t) lround(KdMain * multiple);
+    setMainTunedGains(&tuned);
+    getMainGains(FLYING, INT_TO_Q16(50), &gains);
+    checkTunedGain(tuned.kp, gains.kp);
+    checkTunedGain(tuned.ki, gains.ki);
+    checkTunedGain(tuned.kd, gains.kd);
+}
+
+
+int main(void) {
+    static const double multiples[] = {0.001, 0.1, 1.0, 10.0, 1000.0};
+    const pidGains_t extreme = {Q16_MAX, Q16_MAX, Q16_MAX};
+    pidGains_t gains;
+    pidGains_t flying;
+    unsigned int i;
+
+    checkRelay();
+
+    // AUTOTUNE holds the axis not under test with the FLYING gains
+    for (i = 0; i <= 100; i += 5) {
+        getMainGains(FLYING, INT_TO_Q16(i), &flying);
+        getMainGains(AUTOTUNE, INT_TO_Q16(i), &gains);
+        CHECK(gains.kp == flying.kp && gains.ki == flying.ki && gains.kd == flying.kd);
+        getTailGains(FLYING, INT_TO_Q16(i), &flying);
+        getTailGains(AUTOTUNE, INT_TO_Q16(i), &gains);
+        CHECK(gains.kp == flying.kp && gains.ki == flying.ki && gains.kd == flying.kd);
+    }
+
+    for (i = 0; i < sizeof(multiples) / sizeof(multiples[0]); i++) {
+        checkScale(multiples[i]);
+    }
+
+    // Too large for the scale: every gain must be as large as it can be made,
+    // not wrapped negative
+    setMainTunedGains(&extreme);
+    getMainGains(FLYING, INT_TO_Q16(50), &gains);
+    CHECK(gains.kp == Q16_MAX);
+    CHECK(gains.ki == q16Mul(KiMain, Q16_MAX));
+    CHECK(gains.kd == q16Mul(KdMain, Q16_MAX));
+    getMainGains(LANDING, 0, &gains);
+    CHECK(gains.kp > 0 && gains.ki > 0 && gains.kd > 0);
+    return TEST_RESULT();
+}
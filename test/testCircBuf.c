@@ -0,0 +1,76 @@
+// *******************************************************
+//
+// testCircBuf.c
+//
+// Host tests for the circular buffer (circBufT.c) with the
+// default uint16_t entries. Entries above CIRCBUF_ENTRY_MAX,
+// written one at a time, in bulk or by a fill, must be stored
+// as CIRCBUF_ENTRY_MAX rather than wrapped, and the running
+// sum, and so the mean, must match the stored entries as they
+// are overwritten.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "unitTest.h"
+#include "circBufT.h"
+
+#define BUF_SIZE 8
+
+CIRCBUF_STATIC(buffer, BUF_SIZE);
+
+
+//*****************************************************************************
+//
+// Returns the sum of the stored entries.
+//
+//*****************************************************************************
+static uint32_t sumEntries(void) {
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < BUF_SIZE; i++) {
+        sum += buffer.data[i];
+    }
+    return sum;
+}
+
+
+int main(void) {
+    static const uint32_t bulk[3] = {0x10000, 4095, 0xffffffff};
+    uint32_t i;
+
+    CHECK(CIRCBUF_ENTRY_MAX == 65535);
+
+    // One at a time: 65536 would wrap to 0 if truncated
+    writeCircBuf(&buffer, 0x10000);
+    CHECK(buffer.data[0] == CIRCBUF_ENTRY_MAX);
+    writeCircBuf(&buffer, 65535);
+    CHECK(buffer.data[1] == 65535);
+    writeCircBuf(&buffer, 0x12345);
+    CHECK(buffer.data[2] == CIRCBUF_ENTRY_MAX);
+    CHECK(buffer.sum == sumEntries());
+
+    // In bulk
+    writeCircBufBulk(&buffer, bulk, 3);
+    CHECK(buffer.data[3] == CIRCBUF_ENTRY_MAX);
+    CHECK(buffer.data[4] == 4095);
+    CHECK(buffer.data[5] == CIRCBUF_ENTRY_MAX);
+    CHECK(buffer.sum == sumEntries());
+
+    // Saturated entries are removed from the sum as they are overwritten
+    for (i = 0; i < BUF_SIZE; i++) {
+        writeCircBuf(&buffer, 2000);
+    }
+    CHECK(buffer.sum == 2000 * BUF_SIZE);
+    CHECK(getCircBufMean(&buffer) == 2000);
+
+    // By a fill
+    fillCircBuf(&buffer, 0x20000);
+    CHECK(buffer.sum == sumEntries());
+    CHECK(getCircBufMean(&buffer) == CIRCBUF_ENTRY_MAX);
+    CHECK(getCircBufMeanQ8(&buffer) == (uint32_t) CIRCBUF_ENTRY_MAX << 8);
+    return TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+// *******************************************************
+//
+// testFeedforward.c
+//
+// Host unit tests for the learned tail feedforward table
+// (feedforward.c): interpolation and extrapolation, learning
+// without a step in the tail output, and keeping the table in
+// the EEPROM (the RAM stand-in in stubs/driverlibStub.c).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "unitTest.h"
+#include "driverlib/eeprom.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "feedforward.h"
+#include "control.h"
+#include "pwm.h"
+
+
+//*****************************************************************************
+//
+// Learns the passed residual at a main duty until it has all moved into the
+// table, as updateTailFeedforward() does.
+//
+//*****************************************************************************
+static void learnResidual(q16_t mainDuty, q16_t residual) {
+    int tick;
+
+    for (tick = 0; tick < 2000; tick++) {
+        residual = q16Add(residual, -learnFeedforward(mainDuty, residual));
+    }
+}
+
+
+//*****************************************************************************
+//
+// An empty table gives no feedforward. Once one point is learned, the others
+// are in proportion to the main duty, and duties between points are
+// interpolated.
+//
+//*****************************************************************************
+static void testExtrapolation(void) {
+    initFeedforward();
+    CHECK(getFeedforward(INT_TO_Q16(40)) == 0);
+
+    learnResidual(INT_TO_Q16(40), INT_TO_Q16(30));
+    CHECK_NEAR(getFeedforward(INT_TO_Q16(40)), INT_TO_Q16(30), Q16(0.05));
+    CHECK_NEAR(getFeedforward(INT_TO_Q16(20)), INT_TO_Q16(15), Q16(0.05));
+    CHECK_NEAR(getFeedforward(INT_TO_Q16(80)), INT_TO_Q16(60), Q16(0.05));
+    CHECK_NEAR(getFeedforward(INT_TO_Q16(45)), Q16(33.75), Q16(0.05));
+}
+
+
+//*****************************************************************************
+//
+// Each learning step takes what it adds to the feedforward off the tail
+// integrator, so the tail output must not step while the table learns, at a
+// table point and between points.
+//
+//*****************************************************************************
+static void testBumplessLearning(void) {
+    pidController_t tail;
+    q16_t mainDuties[] = {INT_TO_Q16(50), Q16(63.7)};
+    q16_t mainDuty;
+    q16_t learned;
+    q16_t output;
+    q16_t previous;
+    q16_t worst = 0;
+    unsigned int duty;
+    int tick;
+
+    for (duty = 0; duty < sizeof(mainDuties) / sizeof(mainDuties[0]); duty++) {
+        mainDuty = mainDuties[duty];
+        initFeedforward();
+
+        // A tail integrator holding the torque the empty table is missing
+        initPID(&tail, KpTail, KiTail, KdTail, DELTA_T, YAW_DERIVATIVE_TAU,
+                INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+        adjustPIDIntegral(&tail, INT_TO_Q16(35));
+        setPIDFeedforward(&tail, getFeedforward(mainDuty));
+        previous = updatePID(&tail, 0, 0);
+
+        for (tick = 0; tick < 1000; tick++) {
+            learned = learnFeedforward(mainDuty, getPIDIntegral(&tail));
+            adjustPIDIntegral(&tail, -learned);
+            setPIDFeedforward(&tail, getFeedforward(mainDuty));
+
+            output = updatePID(&tail, 0, 0);
+            if (abs(output - previous) > worst) {
+                worst = abs(output - previous);
+            }
+            previous = output;
+        }
+
+        // The output stays at 35% while the integrator empties into the table
+        CHECK_NEAR(output, INT_TO_Q16(35), 4);
+        CHECK(getPIDIntegral(&tail) < Q16(0.1));
+        CHECK_NEAR(getFeedforward(mainDuty), INT_TO_Q16(35), Q16(0.1));
+    }
+
+    // Only Q16 rounding is allowed between ticks
+    printf("Learning: largest tail output step %d Q16 (%.6f%% duty)\n", worst, (double) worst / Q16_ONE);
+    CHECK(worst <= 4);
+}
+
+
+//*****************************************************************************
+//
+// A saved table must load again after a reset, and a corrupt one must be
+// cleared.
+//
+//*****************************************************************************
+static void testPersistence(void) {
+    initFeedforward();
+    learnResidual(INT_TO_Q16(60), INT_TO_Q16(48));
+    saveFeedforward();
+
+    initFeedforward();
+    CHECK_NEAR(getFeedforward(INT_TO_Q16(60)), INT_TO_Q16(48), Q16(0.05));
+
+    // Flip a bit in the middle of the saved table
+    eepromStub[FF_EEPROM_ADDRESS + 20] ^= 0x01;
+    initFeedforward();
+    CHECK(getFeedforward(INT_TO_Q16(60)) == 0);
+}
+
+
+int main(void) {
+    testExtrapolation();
+    testBumplessLearning();
+    testPersistence();
+    return TEST_RESULT();
+}
@@ -0,0 +1,225 @@
+// *******************************************************
+//
+// testPid.c
+//
+// Host unit tests for the Q16 PID controller (pid.c):
+// conditional-integration anti-windup, derivative on the
+// measurement, the derivative filter, the output clamps,
+// bumpless gain changes and holding the integrator.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+
+#define DT Q16(0.01)
+#define DUTY_MIN INT_TO_Q16(2)
+#define DUTY_MAX INT_TO_Q16(98)
+
+
+//*****************************************************************************
+//
+// While the output is held at a clamp by the error, the integrator must not
+// grow. Once the error reverses the output must leave the clamp at once.
+//
+//*****************************************************************************
+static void testAntiWindup(void) {
+    pidController_t pid;
+    q16_t output = 0;
+    int tick;
+
+    initPID(&pid, Q16(1.0), Q16(1.0), 0, DT, 0, DUTY_MIN, DUTY_MAX);
+
+    // Integrate up to a duty of 50%
+    for (tick = 0; tick < 5000; tick++) {
+        output = updatePID(&pid, INT_TO_Q16(1), 0);
+        if (output >= INT_TO_Q16(50)) {
+            break;
+        }
+    }
+    CHECK(output >= INT_TO_Q16(50) && output < DUTY_MAX);
+
+    // A large error saturates the output for 10s. Without anti-windup the
+    // integrator would gain 1000 * 10 = 10000.
+    for (tick = 0; tick < 1000; tick++) {
+        output = updatePID(&pid, INT_TO_Q16(1000), 0);
+        CHECK(output == DUTY_MAX);
+    }
+    CHECK(getPIDIntegral(&pid) < INT_TO_Q16(60));
+
+    // A small negative error brings the output straight back below the clamp
+    output = updatePID(&pid, -INT_TO_Q16(1), 0);
+    CHECK(output < DUTY_MAX);
+    CHECK(output > INT_TO_Q16(45));
+
+    // At the lower clamp, integration away from the clamp is still allowed
+    initPID(&pid, Q16(1.0), Q16(1.0), 0, DT, 0, DUTY_MIN, DUTY_MAX);
+    output = updatePID(&pid, -INT_TO_Q16(1000), 0);
+    CHECK(output == DUTY_MIN);
+    CHECK(getPIDIntegral(&pid) == 0);
+    output = updatePID(&pid, INT_TO_Q16(1), 0);
+    CHECK(getPIDIntegral(&pid) > 0);
+}
+
+
+//*****************************************************************************
+//
+// A step in the error (a reference change) with the measurement still must
+// not kick the derivative term. A measurement rate must give -Kd * rate.
+//
+//*****************************************************************************
+static void testDerivativeOnMeasurement(void) {
+    pidController_t pid;
+    q16_t output;
+
+    initPID(&pid, 0, 0, Q16(0.5), DT, 0, Q16_MIN, Q16_MAX);
+
+    output = updatePID(&pid, INT_TO_Q16(0), 0);
+    CHECK(output == 0);
+    output = updatePID(&pid, INT_TO_Q16(40), 0);
+    CHECK(output == 0);
+    output = updatePID(&pid, -INT_TO_Q16(40), 0);
+    CHECK(output == 0);
+
+    // With no filter the term follows the rate at once
+    output = updatePID(&pid, 0, INT_TO_Q16(10));
+    CHECK_NEAR(output, -INT_TO_Q16(5), 1);
+    output = updatePID(&pid, 0, -INT_TO_Q16(10));
+    CHECK_NEAR(output, INT_TO_Q16(5), 1);
+}
+
+
+//*****************************************************************************
+//
+// The derivative term must follow a step in the rate as a first-order lag,
+// 1 - (1 - alpha)^n after n updates, with alpha = dt / (tau + dt).
+//
+//*****************************************************************************
+static void testDerivativeFilter(void) {
+    pidController_t pid;
+    q16_t output;
+    double expected = 0.0;
+    double alpha = 0.01 / (0.04 + 0.01);
+    int tick;
+
+    initPID(&pid, 0, 0, Q16(1.0), DT, Q16(0.04), Q16_MIN, Q16_MAX);
+
+    for (tick = 0; tick < 30; tick++) {
+        output = updatePID(&pid, 0, -INT_TO_Q16(20));
+        expected += alpha * (20.0 - expected);
+        CHECK_NEAR(output, Q16(1.0) * expected, Q16(0.01));
+    }
+
+    // The filter is reset with the controller
+    resetPID(&pid);
+    output = updatePID(&pid, 0, -INT_TO_Q16(20));
+    CHECK_NEAR(output, Q16(4.0), Q16(0.01));
+}
+
+
+//*****************************************************************************
+//
+// The output, including the feedforward, must stay within the clamps, and
+// an overflow inside the controller must saturate rather than wrap.
+//
+//*****************************************************************************
+static void testClamps(void) {
+    pidController_t pid;
+    q16_t output;
+    int tick;
+
+    initPID(&pid, Q16(100.0), Q16(50.0), Q16(10.0), DT, Q16(0.02), DUTY_MIN, DUTY_MAX);
+
+    // Errors and rates large enough to overflow Q16 if they wrapped
+    for (tick = 0; tick < 200; tick++) {
+        output = updatePID(&pid, (tick & 1) ? Q16(30000.0) : -Q16(30000.0),
+                           (tick & 2) ? Q16(30000.0) : -Q16(30000.0));
+        CHECK(output >= DUTY_MIN && output <= DUTY_MAX);
+    }
+
+    // The feedforward is added inside the clamps
+    initPID(&pid, Q16(1.0), 0, 0, DT, 0, DUTY_MIN, DUTY_MAX);
+    setPIDFeedforward(&pid, INT_TO_Q16(30));
+    output = updatePID(&pid, INT_TO_Q16(5), 0);
+    CHECK(output == INT_TO_Q16(35));
+    setPIDFeedforward(&pid, INT_TO_Q16(95));
+    output = updatePID(&pid, INT_TO_Q16(5), 0);
+    CHECK(output == DUTY_MAX);
+    setPIDFeedforward(&pid, -INT_TO_Q16(95));
+    output = updatePID(&pid, INT_TO_Q16(5), 0);
+    CHECK(output == DUTY_MIN);
+
+    // Saturating arithmetic
+    CHECK(q16Add(Q16_MAX, 1) == Q16_MAX);
+    CHECK(q16Add(Q16_MIN, -1) == Q16_MIN);
+    CHECK(q16Mul(Q16(20000.0), Q16(20000.0)) == Q16_MAX);
+    CHECK(q16Mul(Q16(20000.0), -Q16(20000.0)) == Q16_MIN);
+}
+
+
+//*****************************************************************************
+//
+// Changing the gains while running must not step the output.
+//
+//*****************************************************************************
+static void testBumplessGains(void) {
+    pidController_t pid;
+    pidGains_t gains = {Q16(3.0), Q16(2.0), 0};
+    q16_t before;
+    q16_t after;
+    int tick;
+
+    initPID(&pid, Q16(1.0), Q16(0.5), 0, DT, 0, DUTY_MIN, DUTY_MAX);
+    for (tick = 0; tick < 300; tick++) {
+        before = updatePID(&pid, INT_TO_Q16(4), 0);
+    }
+
+    setPIDGains(&pid, &gains);
+    after = updatePID(&pid, INT_TO_Q16(4), 0);
+
+    // Only the new integral step, 2.0 * 4 * 0.01, is added
+    CHECK_NEAR(after - before, Q16(0.08), Q16(0.001));
+}
+
+
+//*****************************************************************************
+//
+// While held, the integrator must not move however large the error, and the
+// output must still follow the proportional term and the feedforward. Once
+// released it must integrate again.
+//
+//*****************************************************************************
+static void testIntegralHold(void) {
+    pidController_t pid;
+    q16_t output;
+    int tick;
+
+    initPID(&pid, Q16(1.0), Q16(1.0), 0, DT, 0, DUTY_MIN, DUTY_MAX);
+    adjustPIDIntegral(&pid, INT_TO_Q16(40));
+    setPIDFeedforward(&pid, INT_TO_Q16(5));
+    holdPIDIntegral(&pid, true);
+    for (tick = 0; tick < 500; tick++) {
+        output = updatePID(&pid, INT_TO_Q16(10), 0);
+        CHECK(output == INT_TO_Q16(55));
+    }
+    CHECK(getPIDIntegral(&pid) == INT_TO_Q16(40));
+
+    holdPIDIntegral(&pid, false);
+    updatePID(&pid, INT_TO_Q16(10), 0);
+    CHECK_NEAR(getPIDIntegral(&pid), INT_TO_Q16(40) + Q16(0.1), Q16(0.001));
+}
+
+
+int main(void) {
+    testAntiWindup();
+    testDerivativeOnMeasurement();
+    testDerivativeFilter();
+    testClamps();
+    testBumplessGains();
+    testIntegralHold();
+    return TEST_RESULT();
+}
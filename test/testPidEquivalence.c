@@ -0,0 +1,237 @@
+// *******************************************************
+//
+// testPidEquivalence.c
+//
+// Host check that the Q16 PID controller (pid.c, on the
+// saturating arithmetic of fixedPoint.c) behaves like the same
+// control law in double precision, with the altitude gains
+// from control.h:
+//  - Open loop, both are fed the same random errors and
+//    rates, and their outputs must agree to within Q16
+//    rounding.
+//  - Closed loop, each flies its own copy of the plant model
+//    (heliPlant.h) through the same random altitude steps,
+//    and the integer duties sent to the PWM must agree to
+//    within 1%.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "control.h"
+#include "pwm.h"
+#include "heliPlant.h"
+
+#define OPEN_LOOP_TICKS 20000
+#define CLOSED_LOOP_TICKS 30000             // 300s of flight
+#define STEP_TICKS 300                      // A new altitude reference every 3s
+#define PLANT_STEPS (PLANT_RATE_HZ / CONTROL_RATE_HZ)
+
+// The same law as pid.c in double precision
+typedef struct {
+    double kp;
+    double ki;
+    double kd;
+    double dt;
+    double alpha;
+    double outputMin;
+    double outputMax;
+    double integral;
+    double derivative;
+} doublePid_t;
+
+static uint32_t seed = 1;
+
+
+//*****************************************************************************
+//
+// Returns a pseudo-random number from -1 to 1.
+//
+//*****************************************************************************
+static double randomUnit(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (double)(seed >> 8) / (1u << 23) - 1.0;
+}
+
+
+//*****************************************************************************
+//
+// Initialises the double controller with the same parameters as a Q16 one.
+//
+//*****************************************************************************
+static void initDoublePid(doublePid_t *pid, double kp, double ki, double kd, double dt,
+                          double tau, double outputMin, double outputMax) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->dt = dt;
+    pid->alpha = dt / (tau + dt);
+    pid->outputMin = outputMin;
+    pid->outputMax = outputMax;
+    pid->integral = 0.0;
+    pid->derivative = 0.0;
+}
+
+
+//*****************************************************************************
+//
+// Initialises both controllers with the altitude gains. The double one is
+// given the gains as the Q16 constants actually hold them (0.47 is stored as
+// 30802/65536), so only the arithmetic differs between the two.
+//
+//*****************************************************************************
+static void initAltitudePids(pidController_t *fixed, doublePid_t *reference) {
+    initPID(fixed, KpMain, KiMain, KdMain, DELTA_T, HEIGHT_DERIVATIVE_TAU,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+    initDoublePid(reference, (double) KpMain / Q16_ONE, (double) KiMain / Q16_ONE,
+                  (double) KdMain / Q16_ONE, (double) DELTA_T / Q16_ONE,
+                  (double) HEIGHT_DERIVATIVE_TAU / Q16_ONE, PWM_DUTY_MIN, PWM_DUTY_MAX);
+}
+
+
+//*****************************************************************************
+//
+// The double precision update, as updatePID().
+//
+//*****************************************************************************
+static double updateDoublePid(doublePid_t *pid, double error, double measurementRate) {
+    double proportional = pid->kp * error;
+    double integral = pid->integral + pid->ki * error * pid->dt;
+    double output;
+
+    pid->derivative += pid->alpha * (-pid->kd * measurementRate - pid->derivative);
+
+    output = proportional + integral + pid->derivative;
+    if ((output > pid->outputMax && error > 0) || (output < pid->outputMin && error < 0)) {
+        output = proportional + pid->integral + pid->derivative;
+    } else {
+        pid->integral = integral;
+    }
+
+    if (output > pid->outputMax) {
+        output = pid->outputMax;
+    } else if (output < pid->outputMin) {
+        output = pid->outputMin;
+    }
+    return output;
+}
+
+
+//*****************************************************************************
+//
+// Feeds both controllers the same errors and rates.
+//
+//*****************************************************************************
+static void testOpenLoop(void) {
+    pidController_t fixed;
+    doublePid_t reference;
+    double error;
+    double rate;
+    double difference;
+    double worst = 0.0;
+    int tick;
+
+    initAltitudePids(&fixed, &reference);
+
+    for (tick = 0; tick < OPEN_LOOP_TICKS; tick++) {
+        // Errors within +/-60% and rates within +/-40%/s, quantised to Q16
+        error = (double)(q16_t)(randomUnit() * 60.0 * Q16_ONE) / Q16_ONE;
+        rate = (double)(q16_t)(randomUnit() * 40.0 * Q16_ONE) / Q16_ONE;
+
+        difference = fabs((double) updatePID(&fixed, (q16_t)(error * Q16_ONE), (q16_t)(rate * Q16_ONE)) / Q16_ONE
+                          - updateDoublePid(&reference, error, rate));
+        if (difference > worst) {
+            worst = difference;
+        }
+    }
+
+    printf("Open loop: largest output difference %.5f%% duty over %d ticks\n", worst, OPEN_LOOP_TICKS);
+    CHECK(worst < 0.01);
+}
+
+
+//*****************************************************************************
+//
+// Flies both controllers on their own plants.
+//
+//*****************************************************************************
+static void testClosedLoop(void) {
+    pidController_t fixed;
+    doublePid_t reference;
+    heliPlant_t fixedPlant;
+    heliPlant_t referencePlant;
+    double target = 50.0;
+    double fixedHeight;
+    double referenceHeight;
+    double previousFixedHeight;
+    double previousReferenceHeight;
+    int fixedDuty = 0;
+    int referenceDuty = 0;
+    int differing = 0;
+    int worstDuty = 0;
+    double worstHeight = 0.0;
+    int tick;
+    int step;
+
+    initAltitudePids(&fixed, &reference);
+
+    // Both start integrated up to the hover duty, at the target
+    adjustPIDIntegral(&fixed, Q16(PLANT_HOVER_DUTY));
+    reference.integral = PLANT_HOVER_DUTY;
+    initPlant(&fixedPlant, target, 0.0, 0.5);
+    initPlant(&referencePlant, target, 0.0, 0.5);
+    previousFixedHeight = target;
+    previousReferenceHeight = target;
+
+    for (tick = 0; tick < CLOSED_LOOP_TICKS; tick++) {
+        if (tick % STEP_TICKS == 0) {
+            target = 50.0 + 40.0 * randomUnit();
+        }
+
+        // Both plants see the same noise sequence, and the altitude is
+        // differenced for the rate as in control.c
+        fixedHeight = measurePlantHeight(&fixedPlant);
+        referenceHeight = measurePlantHeight(&referencePlant);
+
+        fixedDuty = Q16_TO_INT(updatePID(&fixed, (q16_t)((target - fixedHeight) * Q16_ONE),
+                                         (q16_t)((fixedHeight - previousFixedHeight) * CONTROL_RATE_HZ * Q16_ONE)));
+        referenceDuty = (int) updateDoublePid(&reference, target - referenceHeight,
+                                              (referenceHeight - previousReferenceHeight) * CONTROL_RATE_HZ);
+        previousFixedHeight = fixedHeight;
+        previousReferenceHeight = referenceHeight;
+
+        if (fixedDuty != referenceDuty) {
+            differing++;
+        }
+        if (abs(fixedDuty - referenceDuty) > worstDuty) {
+            worstDuty = abs(fixedDuty - referenceDuty);
+        }
+        if (fabs(fixedPlant.height - referencePlant.height) > worstHeight) {
+            worstHeight = fabs(fixedPlant.height - referencePlant.height);
+        }
+
+        for (step = 0; step < PLANT_STEPS; step++) {
+            stepPlant(&fixedPlant, fixedDuty, 0.0);
+            stepPlant(&referencePlant, referenceDuty, 0.0);
+        }
+    }
+
+    printf("Closed loop: %d of %d ticks differ in the integer duty, by at most %d%%; "
+           "altitudes differ by at most %.4f%%\n",
+           differing, CLOSED_LOOP_TICKS, worstDuty, worstHeight);
+    CHECK(worstDuty <= 1);
+    CHECK(worstHeight < 0.5);
+}
+
+
+int main(void) {
+    testOpenLoop();
+    testClosedLoop();
+    return TEST_RESULT();
+}
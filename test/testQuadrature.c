@@ -0,0 +1,128 @@
+// *******************************************************
+//
+// testQuadrature.c
+//
+// Host tests for the quadrature decode table (quadrature.c).
+// All 16 transitions are checked against the direction found
+// from the order of the states on the disk, and whole
+// revolutions are decoded from generated channel A and B
+// waveforms, with and without a missed edge.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "unitTest.h"
+#include "quadrature.h"
+#include "yawAngle.h"
+
+// The states in the order clockwise rotation steps through them
+static const int clockwiseOrder[4] = {B_LOW_A_LOW, B_HIGH_A_LOW, B_HIGH_A_HIGH, B_LOW_A_HIGH};
+
+
+//*****************************************************************************
+//
+// Returns the position of a state in the clockwise order.
+//
+//*****************************************************************************
+static int orderOf(int state) {
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (clockwiseOrder[i] == state) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+//*****************************************************************************
+//
+// Every transition must step the count by one in the direction of the
+// rotation, leave it for no change, and count an error when both channels
+// changed.
+//
+//*****************************************************************************
+static void testAllTransitions(void) {
+    int previous;
+    int current;
+    int count;
+    int steps;
+    uint32_t errors;
+
+    for (previous = 0; previous < 4; previous++) {
+        for (current = 0; current < 4; current++) {
+            count = 100;
+            errors = getQuadratureErrors();
+            quadratureDecode(&count, current, previous);
+
+            steps = (orderOf(current) - orderOf(previous) + 4) % 4;
+            if (steps == 2) {
+                CHECK(count == 100);
+                CHECK(getQuadratureErrors() == errors + 1);
+            } else {
+                CHECK(count == 100 + ((steps == 1) ? YAW_INCREMENT : (steps == 3) ? -YAW_DECREMENT : 0));
+                CHECK(getQuadratureErrors() == errors);
+            }
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// Returns the state of the channels after the passed number of edges from
+// angle zero. Channel B leads channel A by a quarter of a cycle clockwise,
+// and each channel has a cycle every 4 edges.
+//
+//*****************************************************************************
+static int channelState(int edges) {
+    int phase = ((edges % 4) + 4) % 4;
+    int channelA = (phase == 2 || phase == 3);
+    int channelB = (phase == 1 || phase == 2);
+
+    return (channelB << 1) | channelA;
+}
+
+
+//*****************************************************************************
+//
+// Decodes a revolution each way from the waveforms, then one with an edge
+// missed, which must be counted as an error and lose the two edges.
+//
+//*****************************************************************************
+static void testRevolutions(void) {
+    int count = 0;
+    int edge;
+    uint32_t errors = getQuadratureErrors();
+
+    for (edge = 1; edge <= TOTAL_SLOTS; edge++) {
+        quadratureDecode(&count, channelState(edge), channelState(edge - 1));
+    }
+    CHECK(count == TOTAL_SLOTS);
+
+    for (edge = TOTAL_SLOTS - 1; edge >= 0; edge--) {
+        quadratureDecode(&count, channelState(edge), channelState(edge + 1));
+    }
+    CHECK(count == 0);
+    CHECK(getQuadratureErrors() == errors);
+
+    // Edge 100 is never seen, so 99 -> 101 changes both channels
+    for (edge = 1; edge <= TOTAL_SLOTS; edge++) {
+        if (edge == 100) {
+            continue;
+        }
+        quadratureDecode(&count, channelState(edge), channelState((edge == 101) ? 99 : edge - 1));
+    }
+    CHECK(count == TOTAL_SLOTS - 2);
+    CHECK(getQuadratureErrors() == errors + 1);
+}
+
+
+int main(void) {
+    testAllTransitions();
+    testRevolutions();
+    return TEST_RESULT();
+}
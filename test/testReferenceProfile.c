@@ -0,0 +1,236 @@
+// *******************************************************
+//
+// testReferenceProfile.c
+//
+// Host simulation of reference changes on the plant model
+// (heliPlant.h), comparing a step in the reference, as before
+// the profiles, with the jerk limited profile (trajectory.h)
+// and its feedforward, as control.c runs them. The gains,
+// profile limits and feedforward gains are those in control.h.
+//
+// The altitude loop is updateHeight() in the FLYING mode. The
+// yaw loop is the default YAW_CONTROL_CASCADE: the outer loop
+// of updateYaw() at CONTROL_RATE_HZ, the tail feedforward of
+// updateTailFeedforward(), and the inner rate loop at
+// YAW_RATE_LOOP_HZ, with the main rotor at the hover duty and
+// a learned tail feedforward of PLANT_COUPLING times it. The
+// altitude and yaw rate estimates are taken to be exact, and
+// the yaw is measured to the nearest slot.
+//
+// For each change of reference the overshoot past the new
+// reference and the settling time (the last time outside the
+// band) are printed. The profile must settle sooner than the
+// step, and overshoot by less than HEIGHT_OVERSHOOT_MAX or
+// YAW_OVERSHOOT_MAX. The yaw is only known to the nearest
+// slot, so the controller cannot see, or remove, an overshoot
+// of under half a slot.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "trajectory.h"
+#include "control.h"
+#include "pwm.h"
+#include "heliPlant.h"
+
+#define HEIGHT_TICKS 2500                   // 25s at CONTROL_RATE_HZ
+#define HEIGHT_BAND 0.5                     // Settled, percent
+#define HEIGHT_OVERSHOOT_MAX 0.1            // Percent
+#define YAW_TICKS 500                       // 5s at CONTROL_RATE_HZ
+#define YAW_BAND 0.5                        // Settled, slots
+#define YAW_OVERSHOOT_MAX 0.5               // Slots, within the rounding of the measured yaw
+#define INNER_TICKS (YAW_RATE_LOOP_HZ / CONTROL_RATE_HZ)
+#define INNER_PLANT_STEPS (PLANT_RATE_HZ / YAW_RATE_LOOP_HZ)
+#define PLANT_STEPS (PLANT_RATE_HZ / CONTROL_RATE_HZ)
+
+typedef struct {
+    double overshoot;           // Past the new reference, in its direction
+    double settling;            // Seconds
+} response_t;
+
+
+//*****************************************************************************
+//
+// Updates the overshoot and settling time with the plant position after a
+// tick.
+//
+//*****************************************************************************
+static void measureResponse(response_t *response, double position, double from, double to,
+                            double band, int tick) {
+    double past = (to > from) ? position - to : to - position;
+
+    if (past > response->overshoot) {
+        response->overshoot = past;
+    }
+    if (fabs(position - to) > band) {
+        response->settling = (double)(tick + 1) / CONTROL_RATE_HZ;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Flies an altitude change from a steady hover, with a step in the reference
+// or with the profile.
+//
+//*****************************************************************************
+static response_t flyHeight(double from, double to, bool profiled) {
+    pidController_t pid;
+    trajectory_t profile;
+    heliPlant_t plant;
+    response_t response = {0.0, 0.0};
+    q16_t height;
+    q16_t rate;
+    int duty;
+    int tick;
+    int step;
+
+    initPID(&pid, KpMain, KiMain, KdMain, DELTA_T, HEIGHT_DERIVATIVE_TAU,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+    adjustPIDIntegral(&pid, Q16(PLANT_HOVER_DUTY));
+    initTrajectory(&profile, HEIGHT_PROFILE_VELOCITY, HEIGHT_PROFILE_ACCELERATION,
+                   HEIGHT_PROFILE_JERK_TICKS, CONTROL_RATE_HZ, 0, Q16(from));
+    initPlant(&plant, from, 0.0, 0.0);
+
+    for (tick = 0; tick < HEIGHT_TICKS; tick++) {
+        height = (q16_t)(plant.height * Q16_ONE);
+        rate = (q16_t)(plant.climbRate * Q16_ONE);
+
+        if (profiled) {
+            setTrajectoryTarget(&profile, Q16(to));
+            updateTrajectory(&profile);
+            setPIDFeedforward(&pid, getTrajectoryFeedforward(&profile, HEIGHT_FF_VELOCITY,
+                                                             HEIGHT_FF_ACCELERATION, HEIGHT_FF_JERK));
+            holdPIDIntegral(&pid, isTrajectoryMoving(&profile));
+            duty = q16ToNearestInt(updatePID(&pid, getTrajectoryPosition(&profile) - height,
+                                             q16Add(rate, -getTrajectoryVelocity(&profile))));
+        } else {
+            duty = q16ToNearestInt(updatePID(&pid, Q16(to) - height, rate));
+        }
+
+        for (step = 0; step < PLANT_STEPS; step++) {
+            stepPlant(&plant, duty, PLANT_COUPLING * duty);
+        }
+        measureResponse(&response, plant.height, from, to, HEIGHT_BAND, tick);
+    }
+    return response;
+}
+
+
+//*****************************************************************************
+//
+// Flies a yaw change from rest, with a step in the reference or with the
+// profile.
+//
+//*****************************************************************************
+static response_t flyYaw(double to, bool profiled) {
+    pidController_t outer;
+    pidController_t inner;
+    trajectory_t profile;
+    heliPlant_t plant;
+    response_t response = {0.0, 0.0};
+    q16_t tailFeedforward = Q16(PLANT_COUPLING * PLANT_HOVER_DUTY);
+    q16_t yaw;
+    q16_t rate;
+    q16_t rateReference;
+    int duty;
+    int tick;
+    int innerTick;
+    int step;
+
+    initPID(&outer, KpYaw, 0, 0, DELTA_T, 0,
+            -INT_TO_Q16(YAW_RATE_REF_MAX), INT_TO_Q16(YAW_RATE_REF_MAX));
+    initPID(&inner, KpTailRate, KiTailRate, 0, YAW_RATE_DELTA_T, 0,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+    setPIDFeedforward(&inner, tailFeedforward);
+    initTrajectory(&profile, YAW_PROFILE_VELOCITY, YAW_PROFILE_ACCELERATION,
+                   YAW_PROFILE_JERK_TICKS, CONTROL_RATE_HZ, INT_TO_Q16(TOTAL_SLOTS), 0);
+    initPlant(&plant, 50.0, 0.0, 0.0);
+
+    for (tick = 0; tick < YAW_TICKS; tick++) {
+        yaw = INT_TO_Q16((int) lround(plant.yaw));
+        rate = (q16_t)(plant.yawRate * Q16_ONE);
+
+        if (profiled) {
+            setTrajectoryTarget(&profile, Q16(to));
+            updateTrajectory(&profile);
+            setPIDFeedforward(&outer, getTrajectoryVelocity(&profile));
+            rateReference = updatePID(&outer, getTrajectoryPosition(&profile) - yaw, rate);
+            setPIDFeedforward(&inner, q16Add(tailFeedforward,
+                                             getTrajectoryFeedforward(&profile, YAW_FF_VELOCITY,
+                                                                      YAW_FF_ACCELERATION, YAW_FF_JERK)));
+            holdPIDIntegral(&inner, isTrajectoryMoving(&profile));
+        } else {
+            rateReference = updatePID(&outer, Q16(to) - yaw, rate);
+        }
+
+        for (innerTick = 0; innerTick < INNER_TICKS; innerTick++) {
+            rate = (q16_t)(plant.yawRate * Q16_ONE);
+            duty = q16ToNearestInt(updatePID(&inner, q16Add(rateReference, -rate), 0));
+            for (step = 0; step < INNER_PLANT_STEPS; step++) {
+                stepPlant(&plant, PLANT_HOVER_DUTY, duty);
+            }
+        }
+        measureResponse(&response, plant.yaw, 0.0, to, YAW_BAND, tick);
+    }
+    return response;
+}
+
+
+//*****************************************************************************
+//
+// Compares the step and the profile for one altitude change.
+//
+//*****************************************************************************
+static void testHeightChange(double from, double to) {
+    response_t step = flyHeight(from, to, false);
+    response_t profile = flyHeight(from, to, true);
+
+    printf("Altitude %2.0f%% -> %2.0f%%: step overshoot %6.3f%% settling %5.2fs, "
+           "profile overshoot %6.3f%% settling %5.2fs\n",
+           from, to, step.overshoot, step.settling, profile.overshoot, profile.settling);
+    CHECK(profile.settling < step.settling);
+    CHECK(profile.overshoot < HEIGHT_OVERSHOOT_MAX);
+}
+
+
+//*****************************************************************************
+//
+// Compares the step and the profile for one yaw change.
+//
+//*****************************************************************************
+static void testYawChange(double to) {
+    response_t step = flyYaw(to, false);
+    response_t profile = flyYaw(to, true);
+
+    printf("Yaw %4.0f slots: step overshoot %6.3f settling %5.2fs, "
+           "profile overshoot %6.3f settling %5.2fs\n",
+           to, step.overshoot, step.settling, profile.overshoot, profile.settling);
+    CHECK(profile.settling < step.settling);
+    CHECK(profile.overshoot < YAW_OVERSHOOT_MAX);
+}
+
+
+int main(void) {
+    // One button press each way, a 30% change, and most of the range
+    testHeightChange(40.0, 40.0 + HEIGHT_STEP);
+    testHeightChange(40.0, 40.0 - HEIGHT_STEP);
+    testHeightChange(20.0, 50.0);
+    testHeightChange(50.0, 20.0);
+    testHeightChange(10.0, 90.0);
+    testHeightChange(90.0, 10.0);
+
+    // One, two and four button presses
+    testYawChange(YAW_STEP);
+    testYawChange(-YAW_STEP);
+    testYawChange(2 * YAW_STEP);
+    testYawChange(4 * YAW_STEP);
+    return TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+// *******************************************************
+//
+// testSlidingMedian.c
+//
+// Host tests for the running median (slidingMedian.c). For
+// each window length, random streams are fed through a filter
+// and, after every sample, its median is compared with that
+// of the same window sorted. The streams run several windows
+// past full, so most samples evict the oldest one. An even
+// number of samples may give either middle value.
+//
+// The streams are 12-bit ADC values, values from 0 to 3 (many
+// ties), and a slow ramp with spikes, as the Hampel filter in
+// main.c sees around a step.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unitTest.h"
+#include "circBufT.h"
+#include "slidingMedian.h"
+
+#define STREAM_WINDOWS 4            // Stream length in windows past the first
+#define STREAM_MIN 500              // Shortest stream, samples
+#define WINDOW_MAX 128
+
+SLIDING_MEDIAN_STATIC(median1, 1);
+SLIDING_MEDIAN_STATIC(median2, 2);
+SLIDING_MEDIAN_STATIC(median3, 3);
+SLIDING_MEDIAN_STATIC(median4, 4);
+SLIDING_MEDIAN_STATIC(median5, 5);
+SLIDING_MEDIAN_STATIC(median15, 15);
+SLIDING_MEDIAN_STATIC(median16, 16);
+SLIDING_MEDIAN_STATIC(median40, 40);
+SLIDING_MEDIAN_STATIC(median41, 41);
+SLIDING_MEDIAN_STATIC(median128, 128);
+
+static slidingMedian_t *const filters[] = {
+    &median1, &median2, &median3, &median4, &median5,
+    &median15, &median16, &median40, &median41, &median128
+};
+
+typedef enum {
+    STREAM_ADC = 0,
+    STREAM_TIES,
+    STREAM_RAMP,
+    STREAMS
+} stream_t;
+
+static uint32_t seed = 12345;
+
+
+//*****************************************************************************
+//
+// Returns the next sample of a stream.
+//
+//*****************************************************************************
+static uint32_t nextSample(stream_t stream, int index) {
+    seed = seed * 1664525u + 1013904223u;
+    switch (stream) {
+    case STREAM_ADC:
+        return (seed >> 16) & 0xfff;
+    case STREAM_TIES:
+        return (seed >> 16) & 0x3;
+    default:
+        if ((seed >> 24) < 16) {
+            return 4095;
+        }
+        return 1000 + index / 3 + ((seed >> 16) & 0x7);
+    }
+}
+
+
+//*****************************************************************************
+//
+// Compares two samples, for qsort().
+//
+//*****************************************************************************
+static int compareSamples(const void *a, const void *b) {
+    uint32_t first = *(const uint32_t *) a;
+    uint32_t second = *(const uint32_t *) b;
+
+    return (first > second) - (first < second);
+}
+
+
+//*****************************************************************************
+//
+// Feeds a stream through a filter, checking the median against the sorted
+// window after every sample. Returns the number of mismatches.
+//
+//*****************************************************************************
+static int checkStream(slidingMedian_t *filter, stream_t stream) {
+    uint32_t window[WINDOW_MAX];
+    uint32_t sorted[WINDOW_MAX];
+    int size = filter->size;
+    int length = size * (STREAM_WINDOWS + 1);
+    int count = 0;
+    int mismatches = 0;
+    uint32_t median;
+    int i;
+
+    if (length < STREAM_MIN) {
+        length = STREAM_MIN;
+    }
+    initSlidingMedian(filter);
+
+    for (i = 0; i < length; i++) {
+        window[i % size] = nextSample(stream, i);
+        insertSlidingMedian(filter, window[i % size]);
+        if (count < size) {
+            count++;
+        }
+
+        memcpy(sorted, window, count * sizeof(sorted[0]));
+        qsort(sorted, count, sizeof(sorted[0]), compareSamples);
+        median = getSlidingMedian(filter);
+        if (median != sorted[count / 2] && (count % 2 != 0 || median != sorted[count / 2 - 1])) {
+            if (mismatches == 0) {
+                printf("Window %d, stream %d, sample %d: median %u, sorted middle %u\n",
+                       size, (int) stream, i, (unsigned int) median, (unsigned int) sorted[count / 2]);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+
+int main(void) {
+    unsigned int filter;
+    int stream;
+
+    for (filter = 0; filter < sizeof(filters) / sizeof(filters[0]); filter++) {
+        for (stream = 0; stream < STREAMS; stream++) {
+            CHECK(checkStream(filters[filter], (stream_t) stream) == 0);
+        }
+    }
+    return TEST_RESULT();
+}
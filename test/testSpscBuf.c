@@ -0,0 +1,168 @@
+// *******************************************************
+//
+// testSpscBuf.c
+//
+// Host stress test of the SPSC ring buffer (spscBufT.c). A
+// producer thread writes a counting sequence with single and
+// bulk writes, retrying what the full buffer drops, while a
+// consumer thread reads it back with reads and with peeks and
+// consumes of random sizes, in another thread. Every sample must
+// arrive once and in order, and the overrun count must match
+// the entries the producer saw dropped. Each side yields when
+// it cannot make progress, so the test also finishes on a
+// single core. The throughput is printed in samples/s; it is a
+// host figure only.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include "unitTest.h"
+#include "benchTimer.h"
+#include "spscBufT.h"
+
+#define SAMPLES 5000000
+#define CHUNK_MAX 32                // Largest bulk write or read
+
+typedef struct {
+    spscBuf_t buffer;
+    uint32_t dropped;               // Entries the producer saw dropped
+    uint32_t received;              // Samples the consumer read
+    uint32_t outOfOrder;            // Samples that were not the next in sequence
+} stress_t;
+
+
+//*****************************************************************************
+//
+// Returns the next value of a linear congruential sequence.
+//
+//*****************************************************************************
+static uint32_t nextRandom(uint32_t *seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+
+//*****************************************************************************
+//
+// Writes the samples 0 to SAMPLES - 1, a single entry or a bulk write of
+// up to CHUNK_MAX at a time, until every sample has been written.
+//
+//*****************************************************************************
+static void *produce(void *argument) {
+    stress_t *stress = argument;
+    uint32_t block[CHUNK_MAX];
+    uint32_t seed = 1;
+    uint32_t next = 0;
+    uint32_t count;
+    uint32_t written;
+    uint32_t i;
+
+    while (next < SAMPLES) {
+        if (nextRandom(&seed) & 1) {
+            if (writeSpscBuf(&stress->buffer, next)) {
+                next++;
+            } else {
+                stress->dropped++;
+                sched_yield();
+            }
+        } else {
+            count = 1 + nextRandom(&seed) % CHUNK_MAX;
+            if (count > SAMPLES - next) {
+                count = SAMPLES - next;
+            }
+            for (i = 0; i < count; i++) {
+                block[i] = next + i;
+            }
+            written = writeSpscBufBulk(&stress->buffer, block, count);
+            stress->dropped += count - written;
+            next += written;
+            if (written == 0) {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+
+//*****************************************************************************
+//
+// Reads the samples back, checking the sequence, with reads or with a peek
+// and a consume of up to CHUNK_MAX at a time.
+//
+//*****************************************************************************
+static void *consume(void *argument) {
+    stress_t *stress = argument;
+    uint32_t block[CHUNK_MAX];
+    uint32_t seed = 2;
+    uint32_t count;
+    uint32_t i;
+
+    while (stress->received < SAMPLES) {
+        if (nextRandom(&seed) & 1) {
+            count = readSpscBuf(&stress->buffer, block, 1 + nextRandom(&seed) % CHUNK_MAX);
+        } else {
+            count = peekSpscBuf(&stress->buffer, block, 1 + nextRandom(&seed) % CHUNK_MAX);
+            consumeSpscBuf(&stress->buffer, count);
+        }
+        for (i = 0; i < count; i++) {
+            if (block[i] != stress->received + i) {
+                stress->outOfOrder++;
+            }
+        }
+        stress->received += count;
+        if (count == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+//*****************************************************************************
+//
+// Runs the producer and consumer on a buffer of the passed size.
+//
+//*****************************************************************************
+static void testStress(uint32_t size) {
+    static uint32_t storage[1024];
+    stress_t stress = {.dropped = 0, .received = 0, .outOfOrder = 0};
+    pthread_t producer;
+    pthread_t consumer;
+    uint64_t start;
+    uint64_t nanos;
+
+    CHECK(size <= sizeof(storage) / sizeof(storage[0]));
+    CHECK(initSpscBuf(&stress.buffer, storage, size));
+
+    start = benchNanos();
+    CHECK(pthread_create(&consumer, NULL, consume, &stress) == 0);
+    CHECK(pthread_create(&producer, NULL, produce, &stress) == 0);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    nanos = benchNanos() - start;
+
+    printf("%4u entries: %.1f M samples/s, %u entries dropped while full\n",
+           (unsigned int) size, SAMPLES * 1000.0 / nanos, (unsigned int) stress.dropped);
+    CHECK(stress.received == SAMPLES);
+    CHECK(stress.outOfOrder == 0);
+    CHECK(stress.buffer.overruns == stress.dropped);
+    CHECK(availableSpscBuf(&stress.buffer) == 0);
+}
+
+
+int main(void) {
+    uint32_t storage[3];
+
+    CHECK(!initSpscBuf(&(spscBuf_t){0}, storage, 3));
+    CHECK(!initSpscBuf(&(spscBuf_t){0}, storage, 0));
+
+    testStress(16);
+    testStress(1024);
+    return TEST_RESULT();
+}
@@ -0,0 +1,186 @@
+// *******************************************************
+//
+// testTailFeedforward.c
+//
+// Host simulation of the learned tail feedforward on the
+// plant model (heliPlant.h). The helicopter holds its yaw
+// while the altitude steps between 30% and 70%, flown as
+// control.c flies it in the FLYING mode: the altitude loop of
+// updateHeight() with its profile, the default cascade yaw
+// loop (the outer loop of updateYaw() at CONTROL_RATE_HZ and
+// the inner rate loop at YAW_RATE_LOOP_HZ), and the learning
+// of updateTailFeedforward(). The estimates are taken to be
+// exact, and the yaw is measured to the nearest slot.
+//
+// Without the table the tail integrator has to follow the
+// main rotor torque. With it, the table first learns in a
+// steady hover from empty, then keeps learning during the
+// steps. The model's hover duty does not depend on the
+// altitude, so the hover teaches one table point and the
+// others are extrapolated from it.
+//
+// The RMS yaw error during the steps is printed for both,
+// and must be lower with the table.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "trajectory.h"
+#include "feedforward.h"
+#include "control.h"
+#include "pwm.h"
+#include "heliPlant.h"
+
+#define LEARN_TICKS 2000                    // 20s steady hover at CONTROL_RATE_HZ
+#define STEP_TICKS 800                      // 8s at each altitude
+#define STEPS 8
+#define STEP_LOW 30.0                       // Percent
+#define STEP_HIGH 70.0                      // Percent
+#define INNER_TICKS (YAW_RATE_LOOP_HZ / CONTROL_RATE_HZ)
+#define INNER_PLANT_STEPS (PLANT_RATE_HZ / YAW_RATE_LOOP_HZ)
+
+typedef struct {
+    pidController_t mainPID;
+    pidController_t tailPID;                // Outer yaw loop
+    pidController_t tailRatePID;            // Inner yaw rate loop
+    trajectory_t heightProfile;
+    heliPlant_t plant;
+    bool useTable;
+    int steadyTicks;
+} flight_t;
+
+
+//*****************************************************************************
+//
+// Starts a steady hover at STEP_LOW, with the tail integrator holding the
+// torque and the table empty.
+//
+//*****************************************************************************
+static void initFlight(flight_t *flight, bool useTable) {
+    initPID(&flight->mainPID, KpMain, KiMain, KdMain, DELTA_T, HEIGHT_DERIVATIVE_TAU,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+    adjustPIDIntegral(&flight->mainPID, Q16(PLANT_HOVER_DUTY));
+    initPID(&flight->tailPID, KpYaw, 0, 0, DELTA_T, 0,
+            -INT_TO_Q16(YAW_RATE_REF_MAX), INT_TO_Q16(YAW_RATE_REF_MAX));
+    initPID(&flight->tailRatePID, KpTailRate, KiTailRate, 0, YAW_RATE_DELTA_T, 0,
+            INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+    adjustPIDIntegral(&flight->tailRatePID, Q16(PLANT_COUPLING * PLANT_HOVER_DUTY));
+    initTrajectory(&flight->heightProfile, HEIGHT_PROFILE_VELOCITY, HEIGHT_PROFILE_ACCELERATION,
+                   HEIGHT_PROFILE_JERK_TICKS, CONTROL_RATE_HZ, 0, Q16(STEP_LOW));
+    initPlant(&flight->plant, STEP_LOW, 0.0, 0.0);
+    initFeedforward();
+    flight->useTable = useTable;
+    flight->steadyTicks = 0;
+}
+
+
+//*****************************************************************************
+//
+// Flies one control tick towards the passed altitude, holding the yaw at 0,
+// and returns the yaw error at the end of it.
+//
+//*****************************************************************************
+static double flyTick(flight_t *flight, double height) {
+    heliPlant_t *plant = &flight->plant;
+    q16_t yawError = -INT_TO_Q16((int) lround(plant->yaw));
+    q16_t yawRate = (q16_t)(plant->yawRate * Q16_ONE);
+    q16_t heightError = (q16_t)((height - plant->height) * Q16_ONE);
+    q16_t rateReference;
+    q16_t mainDuty;
+    q16_t learned = 0;
+    int outputMain;
+    int duty;
+    int innerTick;
+    int step;
+
+    // updateYaw(), the reference is still
+    rateReference = updatePID(&flight->tailPID, yawError, yawRate);
+
+    // updateHeight()
+    setTrajectoryTarget(&flight->heightProfile, Q16(height));
+    updateTrajectory(&flight->heightProfile);
+    setPIDFeedforward(&flight->mainPID, getTrajectoryFeedforward(&flight->heightProfile, HEIGHT_FF_VELOCITY,
+                                                                 HEIGHT_FF_ACCELERATION, HEIGHT_FF_JERK));
+    holdPIDIntegral(&flight->mainPID, isTrajectoryMoving(&flight->heightProfile));
+    outputMain = q16ToNearestInt(updatePID(&flight->mainPID,
+                                           getTrajectoryPosition(&flight->heightProfile)
+                                           - (q16_t)(plant->height * Q16_ONE),
+                                           q16Add((q16_t)(plant->climbRate * Q16_ONE),
+                                                  -getTrajectoryVelocity(&flight->heightProfile))));
+
+    // updateTailFeedforward()
+    if (flight->useTable) {
+        mainDuty = INT_TO_Q16(outputMain);
+        if (yawError < INT_TO_Q16(FF_STEADY_YAW_ERROR) && yawError > -INT_TO_Q16(FF_STEADY_YAW_ERROR)
+            && yawRate < INT_TO_Q16(FF_STEADY_YAW_RATE) && yawRate > -INT_TO_Q16(FF_STEADY_YAW_RATE)
+            && heightError < INT_TO_Q16(FF_STEADY_HEIGHT_ERROR)
+            && heightError > -INT_TO_Q16(FF_STEADY_HEIGHT_ERROR)) {
+            if (flight->steadyTicks < FF_STEADY_TICKS) {
+                flight->steadyTicks++;
+            }
+        } else {
+            flight->steadyTicks = 0;
+        }
+        if (flight->steadyTicks >= FF_STEADY_TICKS) {
+            learned = learnFeedforward(mainDuty, getPIDIntegral(&flight->tailRatePID));
+        }
+        adjustPIDIntegral(&flight->tailRatePID, -learned);
+        setPIDFeedforward(&flight->tailRatePID, getFeedforward(mainDuty));
+    }
+
+    // The inner yaw rate loop until the next control tick
+    for (innerTick = 0; innerTick < INNER_TICKS; innerTick++) {
+        yawRate = (q16_t)(plant->yawRate * Q16_ONE);
+        duty = q16ToNearestInt(updatePID(&flight->tailRatePID, q16Add(rateReference, -yawRate), 0));
+        for (step = 0; step < INNER_PLANT_STEPS; step++) {
+            stepPlant(plant, outputMain, duty);
+        }
+    }
+    return plant->yaw;
+}
+
+
+//*****************************************************************************
+//
+// Learns in a steady hover if the table is used, then flies the altitude
+// steps and returns the RMS yaw error during them, in slots.
+//
+//*****************************************************************************
+static double flySteps(bool useTable) {
+    flight_t flight;
+    double sumSquares = 0.0;
+    double error;
+    int tick;
+
+    initFlight(&flight, useTable);
+    if (useTable) {
+        for (tick = 0; tick < LEARN_TICKS; tick++) {
+            flyTick(&flight, STEP_LOW);
+        }
+        CHECK_NEAR(getFeedforward(Q16(PLANT_HOVER_DUTY)), Q16(PLANT_COUPLING * PLANT_HOVER_DUTY), Q16(0.5));
+    }
+
+    for (tick = 0; tick < STEPS * STEP_TICKS; tick++) {
+        error = flyTick(&flight, ((tick / STEP_TICKS) % 2 == 0) ? STEP_HIGH : STEP_LOW);
+        sumSquares += error * error;
+    }
+    return sqrt(sumSquares / (STEPS * STEP_TICKS));
+}
+
+
+int main(void) {
+    double withoutTable = flySteps(false);
+    double withTable = flySteps(true);
+
+    printf("Altitude steps %2.0f%% <-> %2.0f%%: RMS yaw error %.3f slots without the table, "
+           "%.3f slots with it\n", STEP_LOW, STEP_HIGH, withoutTable, withTable);
+    CHECK(withTable < withoutTable);
+    return TEST_RESULT();
+}
@@ -0,0 +1,198 @@
+// *******************************************************
+//
+// testYawAngle.c
+//
+// Host tests for placing the yaw reference crossing between
+// slot edges (interpolateCrossing() in yawAngle.c). A simulated
+// disk turns past the reference, which falls part way through
+// a slot. The slot edges and the reference edge are timestamped
+// at the 20 MHz timestamp rate, and the latest edge is the one
+// updateYawRate() would see at its next YAW_RATE_HZ tick after
+// the crossing, as in yaw.c.
+//
+// At a constant speed the crossing must be placed to within
+// CONSTANT_SPEED_ERROR_MAX slots, in both directions, from a
+// crawl to several revolutions a second, and across the wrap of
+// the timestamp counter. While the disk speeds up the error is
+// printed and bounded. If the disk turns back before the next
+// edge, the crossing must be taken at the edge before it.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "yawAngle.h"
+
+#define TIMESTAMP_RATE 20000000.0           // Hz
+#define YAW_RATE_HZ 100                     // As yaw.h, the period of updateYawRate()
+#define CONSTANT_SPEED_ERROR_MAX 0.001      // Slots
+#define ACCELERATING_ERROR_MAX 0.05         // Slots
+
+// A disk at position start (slots) at time 0, moving at the speed (slots/s)
+// and acceleration (slots/s^2). The motion must not reverse over the test.
+typedef struct {
+    double start;
+    double speed;
+    double acceleration;
+    uint32_t timestampBase;                 // Timestamp at time 0
+} disk_t;
+
+
+//*****************************************************************************
+//
+// Returns the disk position at a time.
+//
+//*****************************************************************************
+static double positionAt(const disk_t *disk, double time) {
+    return disk->start + disk->speed * time + 0.5 * disk->acceleration * time * time;
+}
+
+
+//*****************************************************************************
+//
+// Returns the time the disk reaches a position, by bisection.
+//
+//*****************************************************************************
+static double timeAt(const disk_t *disk, double position) {
+    double low = 0.0;
+    double high = 100.0;
+    double middle;
+    double direction = (disk->speed > 0.0) ? 1.0 : -1.0;
+    int i;
+
+    for (i = 0; i < 200; i++) {
+        middle = 0.5 * (low + high);
+        if ((positionAt(disk, middle) - position) * direction < 0.0) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return high;
+}
+
+
+//*****************************************************************************
+//
+// Returns the timestamp of a time.
+//
+//*****************************************************************************
+static uint32_t timestampAt(const disk_t *disk, double time) {
+    return disk->timestampBase + (uint32_t) llround(time * TIMESTAMP_RATE);
+}
+
+
+//*****************************************************************************
+//
+// Turns the disk past the reference and returns the error, in slots, of the
+// crossing placed by interpolateCrossing().
+//
+//*****************************************************************************
+static double placeReference(const disk_t *disk, double reference) {
+    int direction = (disk->speed > 0.0) ? 1 : -1;
+    int edge = (direction > 0) ? (int) floor(reference) : (int) ceil(reference);
+    double crossingTime = timeAt(disk, reference);
+    double tickTime = ceil(crossingTime * YAW_RATE_HZ) / YAW_RATE_HZ;
+    int latestEdge;
+    bam_t crossing;
+
+    // The first updateYawRate() tick with an edge after the crossing
+    while (fabs(positionAt(disk, tickTime) - reference) < fabs(edge + direction - reference)) {
+        tickTime += 1.0 / YAW_RATE_HZ;
+    }
+    latestEdge = (direction > 0) ? (int) floor(positionAt(disk, tickTime))
+                                 : (int) ceil(positionAt(disk, tickTime));
+
+    crossing = interpolateCrossing(slotsToBam(edge), timestampAt(disk, timeAt(disk, edge)),
+                                   slotsToBam(latestEdge), timestampAt(disk, timeAt(disk, latestEdge)),
+                                   timestampAt(disk, crossingTime), direction);
+    return (double) bamToSlotsQ16((int32_t)(crossing - slotsQ16ToBam(Q16(reference)))) / Q16_ONE;
+}
+
+
+//*****************************************************************************
+//
+// Places the crossing at a constant speed, in both directions, over a range
+// of speeds and positions of the reference in its slot.
+//
+//*****************************************************************************
+static void testConstantSpeed(void) {
+    static const double speeds[] = {2.0, 20.0, 100.0, 448.0, 2000.0};
+    static const double fractions[] = {0.05, 0.37, 0.5, 0.93};
+    static const uint32_t bases[] = {0, 0xfff00000};  // The second wraps
+    double worst = 0.0;
+    double error;
+    disk_t disk;
+    unsigned int speed;
+    unsigned int fraction;
+    unsigned int base;
+    int direction;
+
+    for (speed = 0; speed < sizeof(speeds) / sizeof(speeds[0]); speed++) {
+        for (fraction = 0; fraction < sizeof(fractions) / sizeof(fractions[0]); fraction++) {
+            for (base = 0; base < sizeof(bases) / sizeof(bases[0]); base++) {
+                for (direction = -1; direction <= 1; direction += 2) {
+                    disk.start = 100.5 - direction * 0.8;
+                    disk.speed = direction * speeds[speed];
+                    disk.acceleration = 0.0;
+                    disk.timestampBase = bases[base];
+
+                    error = placeReference(&disk, 100.0 + fractions[fraction]);
+                    if (fabs(error) > worst) {
+                        worst = fabs(error);
+                    }
+                    CHECK(fabs(error) < CONSTANT_SPEED_ERROR_MAX);
+                }
+            }
+        }
+    }
+    printf("Constant speed: largest crossing error %.6f slots\n", worst);
+}
+
+
+//*****************************************************************************
+//
+// Places the crossing while the disk speeds up. The edges after the
+// crossing come sooner than a constant speed predicts, so the crossing is
+// placed late, by less the more slowly the speed changes.
+//
+//*****************************************************************************
+static void testAccelerating(void) {
+    disk_t disk = {99.0, 20.0, 200.0, 0};
+    double error = placeReference(&disk, 100.37);
+
+    printf("Speeding up 200 slots/s^2 from 20 slots/s: crossing error %.4f slots\n", error);
+    CHECK(fabs(error) < ACCELERATING_ERROR_MAX);
+}
+
+
+//*****************************************************************************
+//
+// If the disk turns back before the next edge, the crossing cannot be
+// interpolated and is taken at the edge before it. So is one with no known
+// direction.
+//
+//*****************************************************************************
+static void testReversal(void) {
+    bam_t edge = slotsToBam(100);
+
+    // Crossed turning clockwise, then turned back past the same edge
+    CHECK(interpolateCrossing(edge, 1000, slotsToBam(99), 5000, 2000, 1) == edge);
+    CHECK(interpolateCrossing(edge, 1000, slotsToBam(101), 5000, 2000, -1) == edge);
+    CHECK(interpolateCrossing(edge, 1000, slotsToBam(101), 5000, 2000, 0) == edge);
+
+    // No edge yet since the one before the crossing
+    CHECK(interpolateCrossing(edge, 1000, edge, 1000, 2000, 1) == edge);
+}
+
+
+int main(void) {
+    testConstantSpeed();
+    testAccelerating();
+    testReversal();
+    return TEST_RESULT();
+}
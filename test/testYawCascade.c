@@ -0,0 +1,137 @@
+// *******************************************************
+//
+// testYawCascade.c
+//
+// Host simulation comparing the two yaw control structures of
+// control.c (YAW_CONTROL) on the plant model (heliPlant.h):
+//  single - one PID at CONTROL_RATE_HZ sets the tail duty from
+//      the yaw error, as updateYaw() in YAW_CONTROL_SINGLE.
+//  cascade - the outer P loop of updateYaw() sets a yaw rate
+//      reference, and the inner PI loop at YAW_RATE_LOOP_HZ
+//      sets the tail duty from the rate error.
+// The gains are those in control.h. Both have the tail
+// feedforward for the hover duty. The yaw rate is taken to be
+// exact, and the yaw is measured to the nearest slot. The
+// reference is stepped, without the profile, so only the loop
+// structures differ.
+//
+// Two cases are flown from a steady hover:
+//  a YAW_STEP change of reference, for the settling time to
+//      within STEP_BAND slots, and
+//  a step of the main duty from the hover duty to
+//      DISTURBANCE_DUTY with the yaw reference held and the
+//      feedforward not updated, so the main rotor torque is a
+//      disturbance the yaw loop must reject. The peak yaw error
+//      and the recovery time to within STEP_BAND are printed.
+// The cascade must settle and recover sooner, with a smaller
+// peak error.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "pid.h"
+#include "control.h"
+#include "pwm.h"
+#include "heliPlant.h"
+
+#define TICKS 2000                          // 20s at CONTROL_RATE_HZ
+#define STEP_BAND 1.0                       // Settled, slots
+#define DISTURBANCE_DUTY 50                 // Main duty, percent
+#define INNER_TICKS (YAW_RATE_LOOP_HZ / CONTROL_RATE_HZ)
+#define INNER_PLANT_STEPS (PLANT_RATE_HZ / YAW_RATE_LOOP_HZ)
+#define PLANT_STEPS (PLANT_RATE_HZ / CONTROL_RATE_HZ)
+
+typedef struct {
+    double peak;                // Largest error from the reference, slots
+    double settling;            // Last time outside STEP_BAND, seconds
+} response_t;
+
+
+//*****************************************************************************
+//
+// Flies the yaw to the reference with the main rotor at the passed duty,
+// with the single loop or the cascade.
+//
+//*****************************************************************************
+static response_t flyYaw(double reference, int mainDuty, bool cascade) {
+    pidController_t yawPID;
+    pidController_t ratePID;
+    heliPlant_t plant;
+    response_t response = {0.0, 0.0};
+    q16_t tailFeedforward = Q16(PLANT_COUPLING * PLANT_HOVER_DUTY);
+    q16_t yawError;
+    q16_t rateReference;
+    q16_t rate;
+    int duty;
+    int tick;
+    int innerTick;
+    int step;
+
+    if (cascade) {
+        initPID(&yawPID, KpYaw, 0, 0, DELTA_T, 0,
+                -INT_TO_Q16(YAW_RATE_REF_MAX), INT_TO_Q16(YAW_RATE_REF_MAX));
+        initPID(&ratePID, KpTailRate, KiTailRate, 0, YAW_RATE_DELTA_T, 0,
+                INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+        setPIDFeedforward(&ratePID, tailFeedforward);
+    } else {
+        initPID(&yawPID, KpTail, KiTail, KdTail, DELTA_T, YAW_DERIVATIVE_TAU,
+                INT_TO_Q16(PWM_DUTY_MIN), INT_TO_Q16(PWM_DUTY_MAX));
+        setPIDFeedforward(&yawPID, tailFeedforward);
+    }
+    initPlant(&plant, 50.0, 0.0, 0.0);
+
+    for (tick = 0; tick < TICKS; tick++) {
+        yawError = Q16(reference) - INT_TO_Q16((int) lround(plant.yaw));
+        rate = (q16_t)(plant.yawRate * Q16_ONE);
+
+        if (cascade) {
+            rateReference = updatePID(&yawPID, yawError, rate);
+            for (innerTick = 0; innerTick < INNER_TICKS; innerTick++) {
+                rate = (q16_t)(plant.yawRate * Q16_ONE);
+                duty = q16ToNearestInt(updatePID(&ratePID, q16Add(rateReference, -rate), 0));
+                for (step = 0; step < INNER_PLANT_STEPS; step++) {
+                    stepPlant(&plant, mainDuty, duty);
+                }
+            }
+        } else {
+            duty = q16ToNearestInt(updatePID(&yawPID, yawError, rate));
+            for (step = 0; step < PLANT_STEPS; step++) {
+                stepPlant(&plant, mainDuty, duty);
+            }
+        }
+
+        if (fabs(plant.yaw - reference) > STEP_BAND) {
+            response.settling = (double)(tick + 1) / CONTROL_RATE_HZ;
+        }
+        if (reference == 0.0 && fabs(plant.yaw) > response.peak) {
+            response.peak = fabs(plant.yaw);
+        }
+    }
+    return response;
+}
+
+
+int main(void) {
+    response_t singleStep = flyYaw(YAW_STEP, (int) PLANT_HOVER_DUTY, false);
+    response_t cascadeStep = flyYaw(YAW_STEP, (int) PLANT_HOVER_DUTY, true);
+    response_t singleDisturbance = flyYaw(0.0, DISTURBANCE_DUTY, false);
+    response_t cascadeDisturbance = flyYaw(0.0, DISTURBANCE_DUTY, true);
+
+    printf("Yaw step of %d slots: settling %.2fs single, %.2fs cascade\n",
+           YAW_STEP, singleStep.settling, cascadeStep.settling);
+    printf("Main duty %d%% -> %d%%: peak error %.2f slots single, %.2f slots cascade; "
+           "recovery %.2fs single, %.2fs cascade\n", (int) PLANT_HOVER_DUTY, DISTURBANCE_DUTY,
+           singleDisturbance.peak, cascadeDisturbance.peak,
+           singleDisturbance.settling, cascadeDisturbance.settling);
+
+    CHECK(cascadeStep.settling < singleStep.settling);
+    CHECK(cascadeDisturbance.peak < singleDisturbance.peak);
+    CHECK(cascadeDisturbance.settling < singleDisturbance.settling);
+    return TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+// *******************************************************
+//
+// testYawQei.c
+//
+// Host tests for the QEI backend of yaw.c
+// (YAW_BACKEND_QEI), built against the simulated QEI0
+// (simYaw.h), which counts and wraps its position and latches
+// its velocity count as the TM4C123 QEI does.
+//
+// Over a random walk of several revolutions each way, the
+// slot count must follow the edges exactly and stay within
+// 0..TOTAL_SLOTS-1, from a zero set anywhere in the
+// revolution, as the QEI position wraps past
+// TOTAL_SLOTS - 1. Setting the zero and aligning it to the
+// reference must mask interrupts down to PRIORITY_YAW_REFERENCE
+// and restore the mask after.
+//
+// At constant speeds each way, the rate must be the edges the
+// QEI counted in its last velocity period scaled to slots/s,
+// with the sign of the direction, and so within one edge a
+// period (YAW_RATE_HZ slots/s) of the speed. Its mean over a
+// second must be within MEAN_RATE_ERROR_MAX of the speed. The
+// scaling, INT_TO_Q16(edges * direction * YAW_RATE_HZ), fits
+// a q16_t up to 32767 slots/s (73 revolutions a second).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/qei.h"
+#include "yaw.h"
+#include "priorities.h"
+#include "simYaw.h"
+
+#define CLOCK_RATE 20000000                 // Hz, SysCtlClockGet() in the stubs
+#define WALK_EDGES 20000
+#define MEAN_RATE_ERROR_MAX 1.0             // Slots/s
+
+
+//*****************************************************************************
+//
+// Returns a slot count reduced to 0..TOTAL_SLOTS-1.
+//
+//*****************************************************************************
+static int wrapSlots(int slots) {
+    return ((slots % TOTAL_SLOTS) + TOTAL_SLOTS) % TOTAL_SLOTS;
+}
+
+
+//*****************************************************************************
+//
+// Walks the disk at random, in runs of up to two revolutions each way, and
+// checks the slot count after every edge. The zero is set part way round
+// first, so the count and the QEI position wrap at different edges.
+//
+//*****************************************************************************
+static void testSlotCount(void) {
+    uint32_t random = 12345;
+    int expected = 0;
+    int direction = 1;
+    int run = 0;
+    int wrong = 0;
+    int outside = 0;
+    int count;
+    int i;
+
+    for (i = 0; i < 300; i++) {
+        simQeiEdge(1);
+    }
+    simHighestPriorityMask();
+    alignYawToReference();
+    CHECK(simHighestPriorityMask() == PRIORITY_YAW_REFERENCE);
+    CHECK(simPriorityMask() == 0);
+    resetYawSlots();
+    CHECK(simHighestPriorityMask() == PRIORITY_YAW_REFERENCE);
+    CHECK(simPriorityMask() == 0);
+    CHECK(getYawSlotCount() == 0);
+
+    for (i = 0; i < WALK_EDGES; i++) {
+        if (run == 0) {
+            random = random * 1664525u + 1013904223u;
+            run = 1 + (random >> 16) % (2 * TOTAL_SLOTS);
+            direction = -direction;
+        }
+        simQeiEdge(direction);
+        expected += direction;
+        run--;
+
+        count = getYawSlotCount();
+        if (count < 0 || count >= TOTAL_SLOTS) {
+            outside++;
+        }
+        if (count != wrapSlots(expected)) {
+            wrong++;
+        }
+        if ((int) QEIPositionGet(QEI0_BASE) != wrapSlots(300 + expected)) {
+            wrong++;
+        }
+    }
+    printf("Random walk of %d edges, %d slots net: %d wrong counts, %d outside 0..%d\n",
+           WALK_EDGES, expected, wrong, outside, TOTAL_SLOTS - 1);
+    CHECK(wrong == 0);
+    CHECK(outside == 0);
+}
+
+
+//*****************************************************************************
+//
+// Turns the disk at a constant speed (slots/s) for a second, with the edges
+// evenly spaced, and checks the rate every velocity period.
+//
+//*****************************************************************************
+static void checkSpeed(int speed) {
+    uint32_t periodCycles = CLOCK_RATE / YAW_RATE_HZ;
+    uint64_t phase = 0;                     // Clock cycles times the speed since the last edge
+    uint32_t cycle;
+    int direction = (speed > 0) ? 1 : -1;
+    int edges = 0;
+    int periods = 0;
+    double sum = 0.0;
+    double rate;
+
+    // The velocity timer restarts with each configuration
+    initYaw();
+
+    // Settle for one period, then check one second
+    for (cycle = 0; cycle < (uint32_t) CLOCK_RATE + periodCycles; cycle += 100) {
+        simQeiClock(100);
+        if ((cycle + 100) % periodCycles == 0) {
+            rate = (double) getYawRate() / Q16_ONE;
+            CHECK(getYawRate() == INT_TO_Q16(direction * edges * YAW_RATE_HZ));
+            CHECK(fabs(rate - speed) <= YAW_RATE_HZ);
+            edges = 0;
+            if (cycle >= periodCycles) {
+                sum += rate;
+                periods++;
+            }
+        }
+
+        phase += 100 * (uint64_t) abs(speed);
+        if (phase >= CLOCK_RATE) {
+            phase -= CLOCK_RATE;
+            simQeiEdge(direction);
+            edges++;
+        }
+    }
+    printf("%6d slots/s: mean rate %.2f slots/s over %d periods\n", speed, sum / periods, periods);
+    CHECK(fabs(sum / periods - speed) <= MEAN_RATE_ERROR_MAX);
+}
+
+
+int main(void) {
+    initYaw();
+    testSlotCount();
+
+    checkSpeed(448);
+    checkSpeed(-448);
+    checkSpeed(50);
+    checkSpeed(-3000);
+    checkSpeed(30000);
+    return TEST_RESULT();
+}
@@ -0,0 +1,213 @@
+// *******************************************************
+//
+// testYawRate.c
+//
+// Host tests for the M/T yaw rate estimate of the GPIO backend
+// (updateYawRate() in yaw.c), built against the simulated
+// encoder and timestamp counter (simYaw.h). A simulated disk
+// turns through a series of phases, each followed by a stop.
+// Each slot edge is raised at its own timestamp, so the
+// quadrature ISR sees the edge times the rig would give, and
+// updateYawRate() is called every 1/YAW_RATE_HZ s. The
+// timestamp counter wraps during the run.
+//
+// At a constant speed the rate must be within
+// CONSTANT_ERROR_MAX of the speed, from a crawl of less than
+// one edge a tick to about 9 revolutions a second. While the
+// disk speeds up or slows to a stop, with at least one edge a
+// tick, the estimate is the mean speed between the last edge
+// before this tick and the last one before the tick before.
+// That lags by up to two ticks, so the error must be within
+// the change in speed over two ticks. Slower than that the
+// estimate is the mean speed over the last slot, and is
+// checked as the disk stops. Once the edges stop, the rate
+// must be no more than one slot over the time since the last
+// edge, must not be zero before YAW_STOPPED_MS, and must be
+// zero after it.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "unitTest.h"
+#include "fixedPoint.h"
+#include "timestamp.h"
+#include "yaw.h"
+#include "simYaw.h"
+
+#define TIMESTAMP_RATE 20000000.0           // Hz, SysCtlClockGet() in the stubs
+#define TIMESTAMP_BASE 0xfff00000u          // Wraps 52 ms into the run
+#define SIM_STEPS_PER_TICK 1000             // Simulation steps per updateYawRate() call
+#define SETTLE_TIME 0.1                     // s into a constant phase before checking
+#define CONSTANT_ERROR_MAX 0.001            // Fraction of the speed
+#define STOP_TIME 1.0                       // s stopped after each phase
+#define LIMIT_TOLERANCE 0.0001              // Of the one slot limit, for the rounded edge times
+#define STOPPED_TOLERANCE 0.000001          // s either side of YAW_STOPPED_MS
+
+// A phase of motion: the speed (slots/s) at its start, the acceleration
+// (slots/s^2) through it, and its length (s)
+typedef struct {
+    double speed;
+    double acceleration;
+    double duration;
+} phase_t;
+
+static const phase_t phases[] = {
+    {448.0, 0.0, 1.0},                      // 1 revolution/s
+    {-20.0, 0.0, 2.0},                      // One edge every 5 ticks
+    {4000.0, 0.0, 0.5},                     // About 9 revolutions/s
+    {50.0, 900.0, 0.5},                     // Speeding up to 500 slots/s
+    {-500.0, 1000.0, 0.5}                   // Slowing to a stop
+};
+
+// The states in the order clockwise rotation steps through them
+static const uint32_t clockwiseOrder[4] = {B_LOW_A_LOW, B_HIGH_A_LOW, B_HIGH_A_HIGH, B_LOW_A_HIGH};
+
+static double simTime;                      // s
+static double position = 0.5;               // Slots
+static int slot;                            // Slot edge last passed
+static double lastEdge;                     // Time of the last edge, s
+
+
+//*****************************************************************************
+//
+// Sets the timestamp counter to a time.
+//
+//*****************************************************************************
+static void setTime(double time) {
+    simSetTimestamp(TIMESTAMP_BASE + (uint32_t) llround(time * TIMESTAMP_RATE));
+}
+
+
+//*****************************************************************************
+//
+// Moves the disk to a new position over one simulation step, raising an
+// edge, at its interpolated time, for each slot edge passed.
+//
+//*****************************************************************************
+static void moveTo(double newPosition, double stepTime) {
+    double edge;
+
+    while (floor(newPosition) > slot || newPosition < slot) {
+        edge = (newPosition > position) ? slot + 1 : slot;
+        lastEdge = simTime + stepTime * (edge - position) / (newPosition - position);
+        setTime(lastEdge);
+        slot += (newPosition > position) ? 1 : -1;
+        simQuadratureEdge(clockwiseOrder[(unsigned int) slot & 3]);
+    }
+    position = newPosition;
+    simTime += stepTime;
+}
+
+
+//*****************************************************************************
+//
+// Calls updateYawRate() at the current time and returns the rate, slots/s.
+//
+//*****************************************************************************
+static double tick(void) {
+    setTime(simTime);
+    updateYawRate();
+    return (double) getYawRate() / Q16_ONE;
+}
+
+
+//*****************************************************************************
+//
+// Runs a phase of motion, checking the rate each tick. Returns the largest
+// error, in slots/s, after the settling time and while there is at least one
+// edge a tick.
+//
+//*****************************************************************************
+static double runPhase(const phase_t *phase) {
+    const double stepTime = 1.0 / (YAW_RATE_HZ * SIM_STEPS_PER_TICK);
+    int ticks = (int) lround(phase->duration * YAW_RATE_HZ);
+    double start = position;
+    double worst = 0.0;
+    double phaseTime = 0.0;
+    double speed;
+    double error;
+    double rate;
+    int t;
+    int step;
+
+    for (t = 0; t < ticks; t++) {
+        for (step = 0; step < SIM_STEPS_PER_TICK; step++) {
+            phaseTime += stepTime;
+            moveTo(start + phase->speed * phaseTime + 0.5 * phase->acceleration * phaseTime * phaseTime,
+                   stepTime);
+        }
+        rate = tick();
+        speed = phase->speed + phase->acceleration * phaseTime;
+        error = fabs(rate - speed);
+
+        if (phaseTime >= SETTLE_TIME && fabs(speed) >= YAW_RATE_HZ && error > worst) {
+            worst = error;
+        }
+    }
+    return worst;
+}
+
+
+//*****************************************************************************
+//
+// Stops the disk for STOP_TIME, checking that the rate is limited to one slot
+// since the last edge, and is zero from YAW_STOPPED_MS and not before.
+//
+//*****************************************************************************
+static void runStop(void) {
+    int ticks = (int) lround(STOP_TIME * YAW_RATE_HZ);
+    double sinceEdge;
+    double rate;
+    int t;
+
+    for (t = 0; t < ticks; t++) {
+        simTime += 1.0 / YAW_RATE_HZ;
+        rate = tick();
+        sinceEdge = simTime - lastEdge;
+
+        CHECK(fabs(rate) <= (1.0 + LIMIT_TOLERANCE) / sinceEdge);
+        if (sinceEdge > YAW_STOPPED_MS / 1000.0 + STOPPED_TOLERANCE) {
+            CHECK(rate == 0.0);
+        } else if (sinceEdge < YAW_STOPPED_MS / 1000.0 - STOPPED_TOLERANCE) {
+            CHECK(rate != 0.0);
+        }
+    }
+}
+
+
+int main(void) {
+    double worst;
+    double bound;
+    unsigned int i;
+
+    simTime = 0.0;
+    setTime(simTime);
+    simQuadratureEdge(clockwiseOrder[0]);
+    initTimestamp();
+    initYaw();
+
+    // At rest
+    for (i = 0; i < YAW_RATE_HZ; i++) {
+        simTime += 1.0 / YAW_RATE_HZ;
+        CHECK(tick() == 0.0);
+    }
+
+    for (i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        worst = runPhase(&phases[i]);
+        if (phases[i].acceleration == 0.0) {
+            bound = CONSTANT_ERROR_MAX * fabs(phases[i].speed);
+        } else {
+            bound = fabs(phases[i].acceleration) * 2.0 / YAW_RATE_HZ;
+        }
+        printf("From %7.1f slots/s at %6.1f slots/s^2: largest rate error %.4f slots/s (limit %.4f)\n",
+               phases[i].speed, phases[i].acceleration, worst, bound);
+        CHECK(worst <= bound);
+        runStop();
+    }
+    CHECK(getQuadratureErrors() == 0);
+    return TEST_RESULT();
+}
@@ -0,0 +1,47 @@
+#ifndef UNITTEST_H_
+#define UNITTEST_H_
+
+// *******************************************************
+//
+// unitTest.h
+//
+// Minimal checks for the host tests. Each test program
+// includes this once, makes its checks, and returns
+// TEST_RESULT() from main(), which ctest treats as a pass
+// when it is zero.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int testFailures;
+
+// Checks a condition, reporting the file and line if it is false
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            testFailures++; \
+        } \
+    } while (0)
+
+// Checks two integers are within tol of each other
+#define CHECK_NEAR(a, b, tol) \
+    do { \
+        long long checkA = (long long)(a); \
+        long long checkB = (long long)(b); \
+        if (llabs(checkA - checkB) > (long long)(tol)) { \
+            printf("%s:%d: check failed: %s = %lld, %s = %lld, tolerance %lld\n", \
+                   __FILE__, __LINE__, #a, checkA, #b, checkB, (long long)(tol)); \
+            testFailures++; \
+        } \
+    } while (0)
+
+// Prints the result, for the return value of main()
+#define TEST_RESULT() \
+    (printf("%s: %d check(s) failed\n", __FILE__, testFailures), testFailures != 0)
+
+#endif /*UNITTEST_H_*/
@@ -0,0 +1,157 @@
+// *******************************************************
+//
+// timestamp.c
+//
+// Free-running 32-bit timestamp counter on TIMER2, and running
+// statistics of periods measured with it.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "fixedPoint.h"
+#include "timestamp.h"
+
+static uint32_t timestampRate;      // Counter rate (the system clock), Hz
+
+
+//*****************************************************************************
+//
+// Initialises TIMER2 as a full-width 32-bit up counter that wraps at 2^32.
+//
+//*****************************************************************************
+void initTimestamp(void) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
+    TimerConfigure(TIMER2_BASE, TIMER_CFG_PERIODIC_UP);
+    TimerLoadSet(TIMER2_BASE, TIMER_A, 0xFFFFFFFF);
+    TimerEnable(TIMER2_BASE, TIMER_A);
+
+    timestampRate = SysCtlClockGet();
+}
+
+
+//*****************************************************************************
+//
+// Returns the current timestamp, in system clock cycles.
+//
+//*****************************************************************************
+uint32_t getTimestamp(void) {
+    return TIMESTAMP_NOW();
+}
+
+
+//*****************************************************************************
+//
+// Returns the timestamp counter rate in Hz.
+//
+//*****************************************************************************
+uint32_t getTimestampRate(void) {
+    return timestampRate;
+}
+
+
+//*****************************************************************************
+//
+// Clears the period statistics, keeping the last timestamp.
+//
+//*****************************************************************************
+void resetPeriodStats(periodStats_t *stats) {
+    stats->count = 0;
+    stats->min = 0;
+    stats->max = 0;
+    stats->mean = 0;
+    stats->m2 = 0;
+}
+
+
+//*****************************************************************************
+//
+// Adds the period since the last update to the statistics, with Welford's
+// update of the mean and the sum of squared differences.
+//
+//*****************************************************************************
+void updatePeriodStats(periodStats_t *stats, uint32_t timestamp) {
+    uint32_t period = timestamp - stats->last;
+    bool started = stats->started;
+    int64_t delta;
+
+    stats->last = timestamp;
+    stats->started = true;
+    if (!started) {
+        return;
+    }
+
+    if (stats->count == 0 || period < stats->min) {
+        stats->min = period;
+    }
+    if (period > stats->max) {
+        stats->max = period;
+    }
+    if (period > PERIOD_STATS_MAX) {
+        period = PERIOD_STATS_MAX;
+    }
+
+    stats->count++;
+    delta = ((int64_t) period << PERIOD_STATS_SHIFT) - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += (delta * (((int64_t) period << PERIOD_STATS_SHIFT) - stats->mean)) >> (2 * PERIOD_STATS_SHIFT);
+}
+
+
+//*****************************************************************************
+//
+// Gets the number of periods since the last reset.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsCount(periodStats_t *stats) {
+    return stats->count;
+}
+
+
+//*****************************************************************************
+//
+// Gets the shortest period, in cycles.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsMin(periodStats_t *stats) {
+    return stats->min;
+}
+
+
+//*****************************************************************************
+//
+// Gets the longest period, in cycles.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsMax(periodStats_t *stats) {
+    return stats->max;
+}
+
+
+//*****************************************************************************
+//
+// Gets the mean period, rounded to whole cycles.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsMean(periodStats_t *stats) {
+    return (uint32_t)((stats->mean + (1 << (PERIOD_STATS_SHIFT - 1))) >> PERIOD_STATS_SHIFT);
+}
+
+
+//*****************************************************************************
+//
+// Gets the sample standard deviation of the period, in cycles.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsStdDev(periodStats_t *stats) {
+    if (stats->count < 2) {
+        return 0;
+    }
+    return sqrt64((uint64_t)(stats->m2 / (stats->count - 1)));
+}
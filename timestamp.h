@@ -0,0 +1,112 @@
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+// *******************************************************
+//
+// timestamp.c
+//
+// Free-running 32-bit timestamp counter on TIMER2, counting
+// up at the system clock rate. It wraps every 2^32 clock
+// cycles (about 215 s at 20 MHz), so intervals must be taken
+// as the unsigned difference of two timestamps. TIMER1 is not
+// used because the OLED delay functions reset it.
+//
+// Also keeps running statistics of the period between calls
+// (e.g. of a control loop), for measuring jitter. The mean and
+// variance are updated with Welford's method, so no periods are
+// stored. For the variance, periods are limited to
+// PERIOD_STATS_MAX cycles so the sums fit in 64 bits; the
+// minimum and maximum are exact.
+//
+// Cost (test/benchPeriodStats.c, host only): 6-8 ns (13-17 host
+// cycles) per update, 23-25 ns per standard deviation read. On
+// the M4 the 64-bit divide of the mean is a library call; its
+// cost there has not been measured.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_timer.h"
+#include "fixedPoint.h"
+
+// Reads the timestamp directly, for use in interrupt handlers
+#define TIMESTAMP_NOW() HWREG(TIMER2_BASE + TIMER_O_TAR)
+
+#define PERIOD_STATS_MAX (1UL << 23)    // Longest period in the variance, cycles (0.42s at 20MHz)
+#define PERIOD_STATS_SHIFT 8            // Fractional bits of the mean
+
+// Running statistics of the period between timestamps. The mean has
+// PERIOD_STATS_SHIFT fractional bits, m2 is the sum of squared differences
+// from the mean in cycles^2.
+typedef struct {
+    uint32_t last;          // Timestamp of the last call
+    bool started;           // Set once there is a last timestamp
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    int64_t mean;
+    int64_t m2;
+} periodStats_t;
+
+
+//*****************************************************************************
+//
+// Initialises and starts the timestamp counter.
+//
+//*****************************************************************************
+void initTimestamp(void);
+
+
+//*****************************************************************************
+//
+// Returns the current timestamp, in system clock cycles.
+//
+//*****************************************************************************
+uint32_t getTimestamp(void);
+
+
+//*****************************************************************************
+//
+// Returns the timestamp counter rate in Hz.
+//
+//*****************************************************************************
+uint32_t getTimestampRate(void);
+
+
+//*****************************************************************************
+//
+// Clears the period statistics. The last timestamp is kept, so the period
+// up to the next update is still counted.
+//
+//*****************************************************************************
+void resetPeriodStats(periodStats_t *stats);
+
+
+//*****************************************************************************
+//
+// Adds the period since the last update to the statistics. The first update
+// only records the timestamp.
+//
+//*****************************************************************************
+void updatePeriodStats(periodStats_t *stats, uint32_t timestamp);
+
+
+//*****************************************************************************
+//
+// Gets the number of periods, and their minimum, maximum, mean and sample
+// standard deviation, in cycles. The standard deviation is 0 with fewer than
+// two periods.
+//
+//*****************************************************************************
+uint32_t getPeriodStatsCount(periodStats_t *stats);
+uint32_t getPeriodStatsMin(periodStats_t *stats);
+uint32_t getPeriodStatsMax(periodStats_t *stats);
+uint32_t getPeriodStatsMean(periodStats_t *stats);
+uint32_t getPeriodStatsStdDev(periodStats_t *stats);
+
+#endif /*TIMESTAMP_H_*/
@@ -0,0 +1,236 @@
+// *******************************************************
+//
+// trajectory.c
+//
+// Jerk limited reference profile, from a velocity and
+// acceleration limited ramp averaged over a window of ticks.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+#include "trajectory.h"
+
+
+//*****************************************************************************
+//
+// Initialises a profile at rest at the passed position.
+//
+//*****************************************************************************
+void initTrajectory(trajectory_t *trajectory, q16_t maxVelocity, q16_t maxAcceleration,
+                    uint16_t jerkTicks, uint32_t rateHz, q16_t wrap, q16_t position) {
+    if (jerkTicks < 1) {
+        jerkTicks = 1;
+    } else if (jerkTicks > TRAJECTORY_WINDOW_MAX) {
+        jerkTicks = TRAJECTORY_WINDOW_MAX;
+    }
+
+    trajectory->maxVelocity = maxVelocity / (int32_t) rateHz;
+    trajectory->maxAcceleration = maxAcceleration / (int32_t)(rateHz * rateHz);
+    if (trajectory->maxAcceleration < 1) {
+        trajectory->maxAcceleration = 1;
+    }
+    trajectory->window = jerkTicks;
+    trajectory->rateHz = rateHz;
+    trajectory->wrap = wrap;
+    resetTrajectory(trajectory, position);
+}
+
+
+//*****************************************************************************
+//
+// Stops the profile at the passed position.
+//
+//*****************************************************************************
+void resetTrajectory(trajectory_t *trajectory, q16_t position) {
+    int tick;
+
+    trajectory->target = position;
+    trajectory->rampPosition = position;
+    trajectory->rampVelocity = 0;
+    for (tick = 0; tick < trajectory->window; tick++) {
+        trajectory->history[tick] = position;
+    }
+    trajectory->sum = (int64_t) position * trajectory->window;
+    trajectory->index = 0;
+    trajectory->position = position;
+    trajectory->velocity = 0;
+    trajectory->acceleration = 0;
+    trajectory->jerk = 0;
+}
+
+
+//*****************************************************************************
+//
+// Sets the position the profile moves to.
+//
+//*****************************************************************************
+void setTrajectoryTarget(trajectory_t *trajectory, q16_t target) {
+    trajectory->target = target;
+}
+
+
+//*****************************************************************************
+//
+// Moves the whole profile by the passed amount.
+//
+//*****************************************************************************
+static void shiftTrajectory(trajectory_t *trajectory, q16_t shift) {
+    int tick;
+
+    trajectory->target += shift;
+    trajectory->rampPosition += shift;
+    for (tick = 0; tick < trajectory->window; tick++) {
+        trajectory->history[tick] += shift;
+    }
+    trajectory->sum += (int64_t) shift * trajectory->window;
+    trajectory->position += shift;
+}
+
+
+//*****************************************************************************
+//
+// Finds the largest ramp speed, per tick, from which the ramp can still stop
+// on the target. Decelerating by u each tick from n u covers u n (n + 1) / 2
+// (including this tick), so n is the largest whole number of steps that fit
+// the distance, and what is left over is spread over the n + 1 ticks.
+//
+//*****************************************************************************
+static int64_t calcStoppingSpeed(int64_t distance, int64_t u) {
+    int64_t steps = ((int64_t) sqrt64((uint64_t)(1 + 8 * (distance / u))) - 1) / 2;
+    int64_t covered = u * steps * (steps + 1) / 2;
+
+    return steps * u + (distance - covered) / (steps + 1);
+}
+
+
+//*****************************************************************************
+//
+// Moves the profile on by one tick. The ramp speed towards the target is
+// limited by the acceleration, the velocity limit, and the stopping speed.
+// The ramp may only reverse at the acceleration limit, so a target behind a
+// moving ramp is overshot, as it must be.
+//
+//*****************************************************************************
+void updateTrajectory(trajectory_t *trajectory) {
+    int64_t distance;
+    int64_t speed;
+    int64_t newSpeed;
+    int64_t limit;
+    int direction;
+    q16_t oldest;
+    q16_t velocity;
+    q16_t acceleration;
+
+    if (trajectory->wrap) {
+        if (trajectory->target >= trajectory->wrap) {
+            shiftTrajectory(trajectory, -trajectory->wrap);
+        } else if (trajectory->target <= -trajectory->wrap) {
+            shiftTrajectory(trajectory, trajectory->wrap);
+        }
+    }
+
+    // Work in the direction of the target
+    distance = (int64_t) trajectory->target - trajectory->rampPosition;
+    direction = (distance < 0) ? -1 : 1;
+    distance *= direction;
+    speed = (int64_t) trajectory->rampVelocity * direction;
+
+    newSpeed = speed + trajectory->maxAcceleration;
+    if (newSpeed > trajectory->maxVelocity) {
+        newSpeed = trajectory->maxVelocity;
+    }
+    limit = calcStoppingSpeed(distance, trajectory->maxAcceleration);
+    if (newSpeed > limit) {
+        newSpeed = limit;
+    }
+    if (newSpeed < speed - trajectory->maxAcceleration) {
+        newSpeed = speed - trajectory->maxAcceleration;
+    }
+
+    trajectory->rampVelocity = (q16_t)(newSpeed * direction);
+    trajectory->rampPosition += trajectory->rampVelocity;
+
+    // Average the ramp over the window
+    oldest = trajectory->history[trajectory->index];
+    trajectory->history[trajectory->index] = trajectory->rampPosition;
+    trajectory->index++;
+    if (trajectory->index >= trajectory->window) {
+        trajectory->index = 0;
+    }
+    trajectory->sum += (int64_t) trajectory->rampPosition - oldest;
+    trajectory->position = (q16_t)(trajectory->sum / trajectory->window);
+
+    velocity = (q16_t)(((int64_t) trajectory->rampPosition - oldest) * trajectory->rateHz / trajectory->window);
+    acceleration = (q16_t)(((int64_t) velocity - trajectory->velocity) * trajectory->rateHz);
+    trajectory->jerk = (q16_t)(((int64_t) acceleration - trajectory->acceleration) * trajectory->rateHz);
+    trajectory->acceleration = acceleration;
+    trajectory->velocity = velocity;
+}
+
+
+//*****************************************************************************
+//
+// Gets the profile position.
+//
+//*****************************************************************************
+q16_t getTrajectoryPosition(trajectory_t *trajectory) {
+    return trajectory->position;
+}
+
+
+//*****************************************************************************
+//
+// Gets the profile velocity, per second.
+//
+//*****************************************************************************
+q16_t getTrajectoryVelocity(trajectory_t *trajectory) {
+    return trajectory->velocity;
+}
+
+
+//*****************************************************************************
+//
+// Gets the profile acceleration, per second squared.
+//
+//*****************************************************************************
+q16_t getTrajectoryAcceleration(trajectory_t *trajectory) {
+    return trajectory->acceleration;
+}
+
+
+//*****************************************************************************
+//
+// Gets the profile jerk, per second cubed.
+//
+//*****************************************************************************
+q16_t getTrajectoryJerk(trajectory_t *trajectory) {
+    return trajectory->jerk;
+}
+
+
+//*****************************************************************************
+//
+// Returns true until the profile has come to rest on its target. The average
+// of the ramp lands exactly on the target, window ticks after the ramp.
+//
+//*****************************************************************************
+bool isTrajectoryMoving(trajectory_t *trajectory) {
+    return trajectory->position != trajectory->target || trajectory->velocity != 0;
+}
+
+
+//*****************************************************************************
+//
+// Returns the feedforward for the profile.
+//
+//*****************************************************************************
+q16_t getTrajectoryFeedforward(trajectory_t *trajectory, q16_t velocityGain,
+                               q16_t accelerationGain, q16_t jerkGain) {
+    return q16Add(q16Add(q16Mul(velocityGain, trajectory->velocity),
+                         q16Mul(accelerationGain, trajectory->acceleration)),
+                  q16Mul(jerkGain, trajectory->jerk));
+}
@@ -0,0 +1,132 @@
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+// *******************************************************
+//
+// trajectory.c
+//
+// Jerk limited (S-curve) reference profile, so a step in a
+// reference is followed smoothly rather than all at once.
+//
+// Each tick the profile first moves a ramp towards the target
+// with limited velocity and acceleration, taking the largest
+// velocity from which it can still stop on the target, so it
+// arrives exactly and never overshoots. The ramp is then
+// averaged over the last jerkTicks ticks. Averaging turns each
+// step in the acceleration into a ramp lasting jerkTicks, so
+// the jerk is at most 2 * maxAcceleration / (jerkTicks / rateHz)
+// (the ramp can go from full acceleration to full deceleration
+// in one tick). As the average of a ramp that does not
+// overshoot, the profile does not overshoot either. The cost
+// is a delay of half the window.
+//
+// The profile velocity is the change of the average, which is
+// the newest ramp value less the one leaving the window, so
+// each tick is constant time.
+//
+// The profile velocity, acceleration and jerk can be fed
+// forward to the controller (getTrajectoryFeedforward()), so it
+// follows the profile without waiting for a tracking error.
+// The jerk term makes up for a lag in the actuator, such as a
+// rotor spinning up.
+//
+// Positions may wrap (e.g. the yaw, every TOTAL_SLOTS): when
+// the target passes +/-wrap the whole profile is moved back by
+// one wrap, which leaves the wrapped position unchanged.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixedPoint.h"
+
+#define TRAJECTORY_WINDOW_MAX 32    // Longest averaging window, ticks
+
+typedef struct {
+    q16_t target;               // Position the profile is moving to
+    q16_t rampPosition;         // Velocity and acceleration limited ramp
+    q16_t rampVelocity;         // Ramp velocity, per tick
+    q16_t maxVelocity;          // Per tick
+    q16_t maxAcceleration;      // Per tick squared
+    q16_t wrap;                 // Wrapping period, 0 for none
+    uint32_t rateHz;            // Rate updateTrajectory() is called at
+    uint16_t window;            // Averaging window, ticks
+    uint16_t index;             // Oldest ramp position in the window
+    q16_t history[TRAJECTORY_WINDOW_MAX]; // Ramp positions in the window
+    int64_t sum;                // Sum of the ramp positions in the window
+    q16_t position;             // Profile position
+    q16_t velocity;             // Profile velocity, per second
+    q16_t acceleration;         // Profile acceleration, per second squared
+    q16_t jerk;                 // Profile jerk, per second cubed
+} trajectory_t;
+
+
+//*****************************************************************************
+//
+// Initialises a profile at rest at the passed position. The velocity (per
+// second) and acceleration (per second squared) limits are Q16, and the jerk
+// is set by the number of ticks (jerkTicks) the acceleration takes to change
+// from zero to its limit. Positions wrap every wrap (Q16) if it is not zero.
+//
+//*****************************************************************************
+void initTrajectory(trajectory_t *trajectory, q16_t maxVelocity, q16_t maxAcceleration,
+                    uint16_t jerkTicks, uint32_t rateHz, q16_t wrap, q16_t position);
+
+
+//*****************************************************************************
+//
+// Stops the profile at the passed position, with the target there too.
+//
+//*****************************************************************************
+void resetTrajectory(trajectory_t *trajectory, q16_t position);
+
+
+//*****************************************************************************
+//
+// Sets the position the profile moves to.
+//
+//*****************************************************************************
+void setTrajectoryTarget(trajectory_t *trajectory, q16_t target);
+
+
+//*****************************************************************************
+//
+// Moves the profile on by one tick.
+//
+//*****************************************************************************
+void updateTrajectory(trajectory_t *trajectory);
+
+
+//*****************************************************************************
+//
+// Gets the profile position, velocity (per second), acceleration (per second
+// squared) and jerk (per second cubed), all Q16.
+//
+//*****************************************************************************
+q16_t getTrajectoryPosition(trajectory_t *trajectory);
+q16_t getTrajectoryVelocity(trajectory_t *trajectory);
+q16_t getTrajectoryAcceleration(trajectory_t *trajectory);
+q16_t getTrajectoryJerk(trajectory_t *trajectory);
+
+
+//*****************************************************************************
+//
+// Returns true until the profile has come to rest on its target.
+//
+//*****************************************************************************
+bool isTrajectoryMoving(trajectory_t *trajectory);
+
+
+//*****************************************************************************
+//
+// Returns the feedforward for the profile, velocityGain times the velocity
+// plus accelerationGain times the acceleration plus jerkGain times the jerk,
+// all Q16, in the units of the controller output.
+//
+//*****************************************************************************
+q16_t getTrajectoryFeedforward(trajectory_t *trajectory, q16_t velocityGain,
+                               q16_t accelerationGain, q16_t jerkGain);
+
+#endif /*TRAJECTORY_H_*/
@@ -26,6 +26,10 @@
 #include "yaw.h"
 #include "utils/ustdlib.h"
 
+// Splits a positive Q16 value for printing with two decimal places
+#define Q16_WHOLE(x) ((x) >> Q16_SHIFT)
+#define Q16_HUNDREDTHS(x) ((((x) & (Q16_ONE - 1)) * 100) >> Q16_SHIFT)
+
 
 //*****************************************************************************
 //
@@ -74,16 +78,78 @@ void UARTSendString(char *message) {
 // over UART.
 //
 //*****************************************************************************
-void UARTSendData(uint16_t landedADCVal, uint16_t meanADCVal, int yawSlotCount) {
-    char UARTOut[100];
+void UARTSendData(uint16_t landedADCVal, uint16_t meanADCVal, bam_t yawAngle, q16_t noiseVariance) {
+    char UARTOut[192];
 
     // Gets data from the calc functions in display.c then creates a string from the data.
-    usnprintf(UARTOut, sizeof(UARTOut),"Mode = %s | PWMMain=%2d | PWMTail=%2d | Yaw=%2d [%2d] | Height=%2d [%2d]\n",
+    // The ADC noise variance (counts^2) is sent with two decimal places, and
+    // the yaw rate in degrees per second. Drift is the slots corrected at the
+    // last yaw reference crossing, with the number of corrections. Inner is the
+    // longest inner yaw rate loop run in cycles.
+    usnprintf(UARTOut, sizeof(UARTOut),"Mode = %s | PWMMain=%2d | PWMTail=%2d | Yaw=%2d [%2d] | Height=%2d [%2d] | Noise=%d.%02d | QErr=%d | YawRate=%d | Drift=%d (%d) | Inner=%d\n",
               getMode(),
               getOutputMain(), getOutputTail(),
-              calcYawDegrees(yawSlotCount), calcYawDegrees(getReferenceYaw()),
-              calcPercentAltitude(landedADCVal, meanADCVal), getReferenceHeight());
+              calcYawDegrees(yawAngle), calcYawDegrees(getReferenceYaw()),
+              calcPercentAltitude(landedADCVal, meanADCVal), getReferenceHeight(),
+              Q16_WHOLE(noiseVariance), Q16_HUNDREDTHS(noiseVariance),
+              getQuadratureErrors(),
+              Q16_TO_INT(getYawRate()) * MAX_DEGREES / TOTAL_SLOTS,
+              getYawDrift(), getYawDriftCorrections(), getYawRateLoopCycles());
 
     UARTSendString(UARTOut);
 
 }
+
+
+//*****************************************************************************
+//
+// Sends the result of an auto-tuning experiment over UART.
+//
+//*****************************************************************************
+void UARTSendTuneResult(char *loop, q16_t ku, q16_t tu, const pidGains_t *gains) {
+    char UARTOut[128];
+
+    if (gains) {
+        usnprintf(UARTOut, sizeof(UARTOut), "Tune %s | Ku=%d.%02d | Tu=%d.%02ds | Kp=%d.%02d | Ki=%d.%02d | Kd=%d.%02d\n",
+                  loop,
+                  Q16_WHOLE(ku), Q16_HUNDREDTHS(ku), Q16_WHOLE(tu), Q16_HUNDREDTHS(tu),
+                  Q16_WHOLE(gains->kp), Q16_HUNDREDTHS(gains->kp),
+                  Q16_WHOLE(gains->ki), Q16_HUNDREDTHS(gains->ki),
+                  Q16_WHOLE(gains->kd), Q16_HUNDREDTHS(gains->kd));
+    } else {
+        usnprintf(UARTOut, sizeof(UARTOut), "Tune %s | Failed\n", loop);
+    }
+
+    UARTSendString(UARTOut);
+}
+
+
+//*****************************************************************************
+//
+// Converts a number of timestamp cycles to hundredths of a microsecond.
+//
+//*****************************************************************************
+static uint32_t cyclesToMicros100(uint32_t cycles) {
+    return (uint32_t)((uint64_t) cycles * 100000000 / getTimestampRate());
+}
+
+
+//*****************************************************************************
+//
+// Sends the statistics of the named period over UART.
+//
+//*****************************************************************************
+void UARTSendPeriodStats(char *name, periodStats_t *stats) {
+    char UARTOut[128];
+    uint32_t mean = cyclesToMicros100(getPeriodStatsMean(stats));
+    uint32_t min = cyclesToMicros100(getPeriodStatsMin(stats));
+    uint32_t max = cyclesToMicros100(getPeriodStatsMax(stats));
+    uint32_t stdDev = cyclesToMicros100(getPeriodStatsStdDev(stats));
+
+    usnprintf(UARTOut, sizeof(UARTOut), "Period %s | N=%d | Mean=%d.%02dus | Min=%d.%02dus | Max=%d.%02dus | SD=%d.%02dus\n",
+              name, getPeriodStatsCount(stats),
+              mean / 100, mean % 100, min / 100, min % 100,
+              max / 100, max % 100, stdDev / 100, stdDev % 100);
+
+    UARTSendString(UARTOut);
+}
@@ -12,6 +12,11 @@
 //
 // *******************************************************
 
+#include <stdint.h>
+#include "fixedPoint.h"
+#include "yaw.h"
+#include "pid.h"
+#include "timestamp.h"
 
 #define BAUD_RATE               9600
 #define UART_USB_BASE           UART0_BASE
@@ -46,6 +51,26 @@ void UARTSendString(char *message);
 // Sends a given string over UART (Based off of code given in the lectures).
 //
 //*****************************************************************************
-void UARTSendData(uint16_t landedADCVal, uint16_t meanADCVal, int yawSlotCount);
+void UARTSendData(uint16_t landedADCVal, uint16_t meanADCVal, bam_t yawAngle, q16_t noiseVariance);
+
+
+//*****************************************************************************
+//
+// Sends the result of an auto-tuning experiment on the named loop: the
+// ultimate gain and period, and the gains found. A null gains pointer reports
+// that the experiment failed.
+//
+//*****************************************************************************
+void UARTSendTuneResult(char *loop, q16_t ku, q16_t tu, const pidGains_t *gains);
+
+
+//*****************************************************************************
+//
+// Sends the statistics of the named period (e.g. of the control loop): the
+// number of periods, and their mean, minimum, maximum and standard deviation
+// in microseconds.
+//
+//*****************************************************************************
+void UARTSendPeriodStats(char *name, periodStats_t *stats);
 
 #endif /*UARTHELI_H_*/
@@ -19,6 +19,9 @@
 #include "userInput.h"
 #include "control.h"
 
+static bool upHeld;     // Set while the UP button is held
+static int upReference; // Altitude reference before UP was pushed
+
 
 //*****************************************************************************
 //
@@ -65,17 +68,26 @@ void checkButtons(void) {
     // If UP button has been pushed, increment the reference altitude by 10%
     switch (butState) {
         case PUSHED:
+            upReference = getReferenceHeight();
             setReferenceUp();
+            upHeld = true;
             break;
         case RELEASED:
+            upHeld = false;
             break;
     }
 
     butState = checkButton(DOWN);
-    // If DOWN button has been pushed, decrement the reference altitude by 10%
+    // If DOWN button has been pushed, decrement the reference altitude by 10%,
+    // or start auto-tuning if UP is held, back at the reference from before
+    // UP was pushed
     switch (butState) {
         case PUSHED:
-            setReferenceDown();
+            if (upHeld) {
+                startAutotune(upReference);
+            } else {
+                setReferenceDown();
+            }
             break;
         case RELEASED:
             break;
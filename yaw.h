@@ -1,37 +1,143 @@
 #ifndef YAW_H_
 #define YAW_H_
 
+// *******************************************************
+//
+// yaw.c
+//
+// Measurement of the helicopter yaw from the quadrature
+// encoder on the disk (448 slot edges per revolution).
+//
+// Two backends are available, chosen at build time with
+// YAW_BACKEND. Both give the same interface below.
+//  YAW_BACKEND_GPIO - the encoder channels A and B are on PB0
+//      and PB1. Every edge raises a GPIO interrupt, which
+//      decodes the transition in software and timestamps it
+//      (timestamp.h). The rate is estimated from the edge times,
+//      and the yaw reference crossing is interpolated between
+//      edges. initTimestamp() must be called before initYaw().
+//  YAW_BACKEND_QEI - the QEI0 peripheral counts the edges and
+//      measures the velocity in hardware, with no interrupts.
+//      QEI0 is only available on PD6 (PhA0) and PD7 (PhB0), so
+//      channel A must be jumpered to PD6 and channel B to PD7.
+//      PD7 is locked at reset and is unlocked by initYaw().
+//      The rate is the edges counted in each 1/YAW_RATE_HZ
+//      period, so it moves in steps of YAW_RATE_HZ slots/s.
+//
+// The slot count wraps to 0..TOTAL_SLOTS-1. The yaw angle is
+// given as a 32-bit binary angle (bam_t), and converted with the
+// helpers in yawAngle.h.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+#include "yawAngle.h"
+#include "quadrature.h"
+
+#define YAW_BACKEND_GPIO 0
+#define YAW_BACKEND_QEI 1
+
+#ifndef YAW_BACKEND
+#define YAW_BACKEND YAW_BACKEND_GPIO
+#endif
+
+#define CHANNEL_A GPIO_PIN_0
+#define CHANNEL_B GPIO_PIN_1
+
+// QEI velocity period. The GPIO rate estimate does not depend on how often
+// updateYawRate() is called.
+#define YAW_RATE_HZ 100
+#define YAW_STOPPED_MS 500  // No edge for this long means a yaw rate of zero
+#define YAW_DRIFT_MAX 20    // Largest drift, in slots, corrected at a reference crossing
+
+
+//*****************************************************************************
+//
+// Initialises the yaw backend chosen by YAW_BACKEND.
+//
+//*****************************************************************************
+void initYaw(void);
+
+
+//*****************************************************************************
+//
+// Returns the yaw slot count, 0 to TOTAL_SLOTS - 1, rounded to the nearest
+// slot. Clockwise rotation counts up.
+//
+//*****************************************************************************
+int getYawSlotCount(void);
+
+
+//*****************************************************************************
+//
+// Returns the yaw angle as a binary angle.
+//
+//*****************************************************************************
+bam_t getYawAngle(void);
 
-// Possible states of the yaw sensors
-// The yaw signals are on pins 0 and 1. GPIOPinRead returns a bit packed
-// byte where the zeroth bit is the state of pin 0, the first bit is the state 
-// of pin 1 on the port, etc. Bits two to seven are not read by the quadrature decoder,
-// and hence their bit in the returned byte is zero. So PB0 low and PB1 low returns 0x00
-// when read, PB0 high and PB1 low returns 0x01 when read etc.
-enum yawStates {B_LOW_A_LOW = 0, B_LOW_A_HIGH, B_HIGH_A_LOW, B_HIGH_A_HIGH};
 
-#define TOTAL_SLOTS 448
-#define YAW_INCREMENT 1
-#define YAW_DECREMENT 1
-#define MAX_DEGREES 360
-#define HALF_DEGREES 180
+//*****************************************************************************
+//
+// Sets the yaw slot count to zero and stops drift correction until the yaw is
+// next aligned to the reference.
+//
+//*****************************************************************************
+void resetYawSlots(void);
+
+
+//*****************************************************************************
+//
+// Records a crossing of the independent yaw reference (PC4), and corrects the
+// slot count for any drift once the yaw has been aligned to the reference.
+// Called from the reference ISR.
+//
+//*****************************************************************************
+void yawReferenceCrossed(void);
+
+
+//*****************************************************************************
+//
+// Sets the yaw to zero at the last reference crossing, and starts drift
+// correction on the following crossings. With the GPIO backend the crossing
+// is interpolated between slot edges, so the zero is finer than one slot.
+//
+//*****************************************************************************
+void alignYawToReference(void);
+
+
+//*****************************************************************************
+//
+// Returns the drift, in slots, removed at the last reference crossing.
+//
+//*****************************************************************************
+int getYawDrift(void);
+
+
+//*****************************************************************************
+//
+// Returns the number of reference crossings at which drift was removed.
+//
+//*****************************************************************************
+uint32_t getYawDriftCorrections(void);
 
 
 //*****************************************************************************
 //
-// Determines the rotation direction of the disk and increments or decrements
-// the slot count appropriately. Sets the slot count to zero if the maximum
-// number is exceeded (i.e. 360 degrees rotation performed).
+// Updates the yaw rate. Called at YAW_RATE_HZ (from SysTick).
+// The QEI backend measures the rate in hardware and ignores this call.
 //
 //*****************************************************************************
-void quadratureDecode(int* yawSlotCount, int currentYawState, int previousYawState);
+void updateYawRate(void);
 
 
 //*****************************************************************************
 //
-// Returns the yaw in degrees of the helicopter
+// Returns the yaw rate in Q16 slots per second. Clockwise is positive.
 //
 //*****************************************************************************
-int16_t calcYawDegrees(int yawSlotCount);
+q16_t getYawRate(void);
 
 #endif /*YAW_H_*/
@@ -0,0 +1,89 @@
+// *******************************************************
+//
+// yawAngle.c
+//
+// Yaw angle arithmetic that needs no hardware (see
+// yawAngle.h).
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+#include "yawAngle.h"
+
+
+//*****************************************************************************
+//
+// Returns the binary angle of a (signed) number of slots.
+//
+//*****************************************************************************
+bam_t slotsToBam(int slots) {
+    return (bam_t) slots * BAM_PER_SLOT;
+}
+
+
+//*****************************************************************************
+//
+// Returns a signed binary angle difference as Q16 slots:
+// angle * TOTAL_SLOTS / 2^32 with 16 fractional bits.
+//
+//*****************************************************************************
+q16_t bamToSlotsQ16(int32_t angle) {
+    return (q16_t)(((int64_t) angle * TOTAL_SLOTS) >> (32 - Q16_SHIFT));
+}
+
+
+//*****************************************************************************
+//
+// Returns Q16 slots as a binary angle: slots * 2^32 / TOTAL_SLOTS without
+// the 16 fractional bits.
+//
+//*****************************************************************************
+bam_t slotsQ16ToBam(q16_t slots) {
+    return (bam_t)(((int64_t) slots << (32 - Q16_SHIFT)) / TOTAL_SLOTS);
+}
+
+
+//*****************************************************************************
+//
+// Returns the yaw angle in degrees, from a binary angle.
+//
+//*****************************************************************************
+int16_t calcYawDegrees(bam_t yawAngle) {
+    // Scale the top 16 bits of the angle to 0 to 359 degrees, then offset to
+    // the range -180 to +179 degrees.
+    return (int16_t)((((yawAngle >> 16) * MAX_DEGREES) >> 16) - HALF_DEGREES);
+}
+
+
+//*****************************************************************************
+//
+// Places a reference crossing between slot edges. The crossing is the
+// fraction of the slots travelled since edgeAngle that had been travelled by
+// crossingTime, limited to less than one slot past edgeAngle.
+//
+//*****************************************************************************
+bam_t interpolateCrossing(bam_t edgeAngle, uint32_t edgeTime, bam_t angle, uint32_t latestEdgeTime,
+                          uint32_t crossingTime, int direction) {
+    int32_t moved = (int32_t)(angle - edgeAngle);
+    uint32_t slots;
+    uint32_t fraction;
+
+    if (moved == 0 || latestEdgeTime == edgeTime || direction == 0 || (moved > 0) != (direction > 0)) {
+        return edgeAngle;
+    }
+
+    // Slots travelled since the edge before the crossing
+    slots = (uint32_t)(bamToSlotsQ16(moved > 0 ? moved : -moved) + Q16_ONE / 2) >> Q16_SHIFT;
+
+    // Fraction of a slot travelled at the crossing, Q16
+    fraction = (uint32_t)(((uint64_t)(crossingTime - edgeTime) * slots << Q16_SHIFT) /
+                          (uint32_t)(latestEdgeTime - edgeTime));
+    if (fraction >= Q16_ONE) {
+        fraction = Q16_ONE - 1;
+    }
+    fraction = (uint32_t)(((uint64_t) fraction * BAM_PER_SLOT) >> Q16_SHIFT);
+    return (direction > 0) ? edgeAngle + fraction : edgeAngle - fraction;
+}
@@ -0,0 +1,91 @@
+#ifndef YAWANGLE_H_
+#define YAWANGLE_H_
+
+// *******************************************************
+//
+// yawAngle.c
+//
+// Yaw angle arithmetic that needs no hardware: conversions
+// between slots, binary angles and degrees, and placing the
+// yaw reference crossing between slot edges. Used by yaw.c,
+// and built on the host for the tests in test/.
+//
+// The yaw angle is a 32-bit binary angle (bam_t), where 2^32
+// is one revolution, so angles and angle differences wrap
+// naturally with unsigned arithmetic, and (int32_t)(a - b) is
+// the shortest signed angle from b to a. Converting a BAM to
+// degrees is a multiply and two shifts, about 5 cycles,
+// compared with two divides and a multiply plus a branch
+// (about 20 to 35 cycles on the Cortex-M4, depending on the
+// divide operands) for the old % and / conversion of an
+// unbounded slot count. These are estimates from the
+// instruction timings, not measurements.
+//
+// Joshua Hulbert, Josiah Craw, Yifei Ma
+//
+// *******************************************************
+
+#include <stdint.h>
+#include "fixedPoint.h"
+
+#define TOTAL_SLOTS 448
+#define MAX_DEGREES 360
+#define HALF_DEGREES 180
+
+// Binary angle: one revolution is 2^32
+typedef uint32_t bam_t;
+
+// BAM per slot, 2^32 / TOTAL_SLOTS rounded up. Slot angles are exact to
+// within 192 BAM (0.00002 degrees) over a revolution.
+#define BAM_PER_SLOT 9586981
+#define BAM_HALF_TURN 0x80000000
+
+
+//*****************************************************************************
+//
+// Returns the binary angle of a (signed) number of slots.
+//
+//*****************************************************************************
+bam_t slotsToBam(int slots);
+
+
+//*****************************************************************************
+//
+// Returns a signed binary angle difference as Q16 slots.
+//
+//*****************************************************************************
+q16_t bamToSlotsQ16(int32_t angle);
+
+
+//*****************************************************************************
+//
+// Returns Q16 slots as a binary angle, wrapping every TOTAL_SLOTS.
+//
+//*****************************************************************************
+bam_t slotsQ16ToBam(q16_t slots);
+
+
+//*****************************************************************************
+//
+// Returns the yaw in degrees of the helicopter, -180 to 179, from a binary
+// angle. A zero angle is -180 degrees.
+//
+//*****************************************************************************
+int16_t calcYawDegrees(bam_t yawAngle);
+
+
+//*****************************************************************************
+//
+// Places a reference crossing between slot edges. The crossing came at
+// crossingTime, after the edge that set edgeAngle at edgeTime, while turning
+// in the passed direction (+1, -1 or 0 if unknown). The latest edge set angle
+// at latestEdgeTime. If the yaw has moved on in the same direction, the
+// crossing is interpolated from its time between the two edges, assuming a
+// constant speed over those slots. Otherwise it is taken to be edgeAngle.
+// Times are timestamps (timestamp.h) and may wrap.
+//
+//*****************************************************************************
+bam_t interpolateCrossing(bam_t edgeAngle, uint32_t edgeTime, bam_t angle, uint32_t latestEdgeTime,
+                          uint32_t crossingTime, int direction);
+
+#endif /*YAWANGLE_H_*/